@@ -0,0 +1,198 @@
+#include <string.h>
+#include <bitboard.h>
+
+// ============================================================================
+// ATTACK AND GEOMETRY TABLES
+// ============================================================================
+
+Bitboard knightAttacks[NUM_SQUARES];
+Bitboard kingAttacks[NUM_SQUARES];
+Bitboard pawnAttacks[2][NUM_SQUARES];
+Bitboard rayBB[NUM_DIRECTIONS][NUM_SQUARES];
+Bitboard betweenBB[NUM_SQUARES][NUM_SQUARES];
+Bitboard lineBB[NUM_SQUARES][NUM_SQUARES];
+
+SliderMagic bishopMagics[NUM_SQUARES];
+SliderMagic rookMagics[NUM_SQUARES];
+
+// Shared attack storage for all squares (sum of 2^bits over every square)
+#define BISHOP_TABLE_SIZE 5248
+#define ROOK_TABLE_SIZE 102400
+static Bitboard bishopTable[BISHOP_TABLE_SIZE];
+static Bitboard rookTable[ROOK_TABLE_SIZE];
+
+static int bitboardsInitialized = 0;
+
+// Row/col steps, indexed by the DIR_* constants
+static const int directionSteps[NUM_DIRECTIONS][2] = {
+    {-1, 0}, {1, 0}, {0, -1}, {0, 1},     // N, S, W, E
+    {-1, -1}, {-1, 1}, {1, -1}, {1, 1}    // NW, NE, SW, SE
+};
+
+static const int oppositeDirection[NUM_DIRECTIONS] = {
+    DIR_S, DIR_N, DIR_E, DIR_W, DIR_SE, DIR_SW, DIR_NE, DIR_NW
+};
+
+static const int knightSteps[8][2] = {
+    {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2},
+    {1, -2}, {1, 2}, {2, -1}, {2, 1}
+};
+
+static int onBoard(int row, int col) {
+    return row >= 0 && row < 8 && col >= 0 && col < 8;
+}
+
+// Walk each direction until the edge or the first blocker (inclusive)
+static Bitboard slidingAttacksSlow(int sq, Bitboard occupied, int firstDir, int lastDir) {
+    Bitboard attacks = 0;
+    for (int dir = firstDir; dir <= lastDir; dir++) {
+        int row = SQUARE_ROW(sq) + directionSteps[dir][0];
+        int col = SQUARE_COL(sq) + directionSteps[dir][1];
+        while (onBoard(row, col)) {
+            Bitboard bb = SQUARE_BB(SQUARE(row, col));
+            attacks |= bb;
+            if (occupied & bb) break;
+            row += directionSteps[dir][0];
+            col += directionSteps[dir][1];
+        }
+    }
+    return attacks;
+}
+
+static void initLeaperTables(void) {
+    for (int sq = 0; sq < NUM_SQUARES; sq++) {
+        int row = SQUARE_ROW(sq);
+        int col = SQUARE_COL(sq);
+
+        for (int i = 0; i < 8; i++) {
+            int r = row + knightSteps[i][0];
+            int c = col + knightSteps[i][1];
+            if (onBoard(r, c)) knightAttacks[sq] |= SQUARE_BB(SQUARE(r, c));
+
+            r = row + directionSteps[i][0];
+            c = col + directionSteps[i][1];
+            if (onBoard(r, c)) kingAttacks[sq] |= SQUARE_BB(SQUARE(r, c));
+        }
+
+        // White pawns capture towards row 0, black pawns towards row 7
+        for (int dc = -1; dc <= 1; dc += 2) {
+            if (onBoard(row - 1, col + dc)) pawnAttacks[0][sq] |= SQUARE_BB(SQUARE(row - 1, col + dc));
+            if (onBoard(row + 1, col + dc)) pawnAttacks[1][sq] |= SQUARE_BB(SQUARE(row + 1, col + dc));
+        }
+    }
+}
+
+static void initRayTables(void) {
+    for (int sq = 0; sq < NUM_SQUARES; sq++) {
+        for (int dir = 0; dir < NUM_DIRECTIONS; dir++) {
+            rayBB[dir][sq] = slidingAttacksSlow(sq, 0, dir, dir);
+        }
+    }
+
+    // Squares strictly between two aligned squares, and the full line through them
+    for (int a = 0; a < NUM_SQUARES; a++) {
+        for (int dir = 0; dir < NUM_DIRECTIONS; dir++) {
+            Bitboard ray = rayBB[dir][a];
+            int opposite = oppositeDirection[dir];
+            while (ray) {
+                int b = popLsb(&ray);
+                betweenBB[a][b] = rayBB[dir][a] & rayBB[opposite][b];
+                lineBB[a][b] = rayBB[dir][a] | rayBB[opposite][a] | SQUARE_BB(a);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// MAGIC SLIDER LOOKUPS
+// ============================================================================
+
+#ifndef USE_PEXT
+// Fixed-seed xorshift64* so the magics are found the same way on every run
+static Bitboard magicSeed = 0x9E3779B97F4A7C15ULL;
+
+static Bitboard nextRandom(void) {
+    magicSeed ^= magicSeed >> 12;
+    magicSeed ^= magicSeed << 25;
+    magicSeed ^= magicSeed >> 27;
+    return magicSeed * 0x2545F4914F6CDD1DULL;
+}
+#endif
+
+// Relevant occupancy: the rays without their final edge square
+static Bitboard relevantMask(int sq, int firstDir, int lastDir) {
+    Bitboard mask = 0;
+    for (int dir = firstDir; dir <= lastDir; dir++) {
+        Bitboard ray = rayBB[dir][sq];
+        if (ray) {
+            int edge = (dir == DIR_N || dir == DIR_W || dir == DIR_NW || dir == DIR_NE)
+                       ? lsbIndex(ray) : 63 - __builtin_clzll(ray);
+            mask |= ray & ~SQUARE_BB(edge);
+        }
+    }
+    return mask;
+}
+
+static void initSliderMagics(SliderMagic* magics, Bitboard* table, int firstDir, int lastDir) {
+    static Bitboard occupancies[4096];
+    static Bitboard reference[4096];
+    Bitboard* next = table;
+#ifndef USE_PEXT
+    static int epoch[4096];
+    int attempt = 0;
+
+    memset(epoch, 0, sizeof(epoch));
+#endif
+
+    for (int sq = 0; sq < NUM_SQUARES; sq++) {
+        SliderMagic* m = &magics[sq];
+        m->mask = relevantMask(sq, firstDir, lastDir);
+        m->shift = 64 - popCount(m->mask);
+        m->attacks = next;
+
+        // Enumerate every subset of the mask (carry-rippler)
+        int size = 0;
+        Bitboard subset = 0;
+        do {
+            occupancies[size] = subset;
+            reference[size] = slidingAttacksSlow(sq, subset, firstDir, lastDir);
+            size++;
+            subset = (subset - m->mask) & m->mask;
+        } while (subset);
+        next += size;
+
+#ifdef USE_PEXT
+        for (int i = 0; i < size; i++) {
+            m->attacks[_pext_u64(occupancies[i], m->mask)] = reference[i];
+        }
+#else
+        // Try sparse random multipliers until one maps without destructive collisions
+        for (int i = 0; i < size; ) {
+            do {
+                m->magic = nextRandom() & nextRandom() & nextRandom();
+            } while (popCount((m->mask * m->magic) >> 56) < 6);
+
+            attempt++;
+            for (i = 0; i < size; i++) {
+                unsigned idx = (unsigned)(((occupancies[i] & m->mask) * m->magic) >> m->shift);
+                if (epoch[idx] < attempt) {
+                    epoch[idx] = attempt;
+                    m->attacks[idx] = reference[i];
+                } else if (m->attacks[idx] != reference[i]) {
+                    break;
+                }
+            }
+        }
+#endif
+    }
+}
+
+void initBitboards(void) {
+    if (bitboardsInitialized) return;
+
+    initLeaperTables();
+    initRayTables();
+    initSliderMagics(bishopMagics, bishopTable, DIR_NW, DIR_SE);
+    initSliderMagics(rookMagics, rookTable, DIR_N, DIR_E);
+    bitboardsInitialized = 1;
+}
@@ -0,0 +1,88 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+// 64-bit board sets. Square indices follow the char board layout:
+// square = row * 8 + col, so 0 is a8 and 63 is h1.
+typedef unsigned long long Bitboard;
+
+#define NUM_SQUARES 64
+#define NO_SQUARE -1
+
+#define SQUARE(row, col) ((row) * 8 + (col))
+#define SQUARE_ROW(sq) ((sq) >> 3)
+#define SQUARE_COL(sq) ((sq) & 7)
+#define SQUARE_BB(sq) (1ULL << (sq))
+
+// Ray directions, in the board's orientation (north is towards row 0)
+#define DIR_N 0
+#define DIR_S 1
+#define DIR_W 2
+#define DIR_E 3
+#define DIR_NW 4
+#define DIR_NE 5
+#define DIR_SW 6
+#define DIR_SE 7
+#define NUM_DIRECTIONS 8
+
+#ifdef USE_PEXT
+#include <immintrin.h>
+#endif
+
+// Occupancy-indexed slider lookup for one square
+typedef struct {
+    Bitboard mask;      // Relevant blockers (rays without their edge squares)
+    Bitboard magic;     // Multiplier mapping mask subsets to unique indices
+    Bitboard* attacks;  // This square's slice of the shared attack table
+    int shift;
+} SliderMagic;
+
+// Tables filled by initBitboards()
+extern Bitboard knightAttacks[NUM_SQUARES];
+extern Bitboard kingAttacks[NUM_SQUARES];
+extern Bitboard pawnAttacks[2][NUM_SQUARES];          // [color][square], 0 = white
+extern Bitboard rayBB[NUM_DIRECTIONS][NUM_SQUARES];   // Empty-board ray from a square
+extern Bitboard betweenBB[NUM_SQUARES][NUM_SQUARES];  // Squares strictly between aligned squares
+extern Bitboard lineBB[NUM_SQUARES][NUM_SQUARES];     // Full line through aligned squares, else 0
+extern SliderMagic bishopMagics[NUM_SQUARES];
+extern SliderMagic rookMagics[NUM_SQUARES];
+
+// Build the attack tables; safe to call more than once
+void initBitboards(void);
+
+static inline int popCount(Bitboard b) {
+    return __builtin_popcountll(b);
+}
+
+// Index of the lowest set bit; b must be non-zero
+static inline int lsbIndex(Bitboard b) {
+    return __builtin_ctzll(b);
+}
+
+// Remove and return the lowest set bit; b must be non-zero
+static inline int popLsb(Bitboard* b) {
+    int sq = __builtin_ctzll(*b);
+    *b &= *b - 1;
+    return sq;
+}
+
+static inline unsigned sliderIndex(const SliderMagic* m, Bitboard occupied) {
+#ifdef USE_PEXT
+    return (unsigned)_pext_u64(occupied, m->mask);
+#else
+    return (unsigned)(((occupied & m->mask) * m->magic) >> m->shift);
+#endif
+}
+
+static inline Bitboard bishopAttacks(int sq, Bitboard occupied) {
+    return bishopMagics[sq].attacks[sliderIndex(&bishopMagics[sq], occupied)];
+}
+
+static inline Bitboard rookAttacks(int sq, Bitboard occupied) {
+    return rookMagics[sq].attacks[sliderIndex(&rookMagics[sq], occupied)];
+}
+
+static inline Bitboard queenAttacks(int sq, Bitboard occupied) {
+    return bishopAttacks(sq, occupied) | rookAttacks(sq, occupied);
+}
+
+#endif
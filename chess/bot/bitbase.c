@@ -0,0 +1,147 @@
+#include <stdlib.h>
+#include <bitbase.h>
+
+// Positions: white king (6 bits), black king (6), side to move (1),
+// pawn file a-d (2), pawn rank 7..2 counted down (3)
+#define KPK_POSITIONS (2 * 24 * 64 * 64)
+
+// Classification during the analysis, as bits so results can be OR-ed
+#define KPK_INVALID 0
+#define KPK_UNKNOWN 1
+#define KPK_DRAW 2
+#define KPK_WIN 4
+
+static unsigned int kpkBits[KPK_POSITIONS / 32];
+static int bitbaseInitialized = 0;
+
+static int kpkIndex(int whiteToMove, int blackKing, int whiteKing, int pawn) {
+    return whiteKing | (blackKing << 6) | (!whiteToMove << 12) |
+           ((pawn & 7) << 13) | ((6 - (pawn >> 3)) << 15);
+}
+
+static int distance(int a, int b) {
+    int ranks = abs((a >> 3) - (b >> 3));
+    int files = abs((a & 7) - (b & 7));
+    return ranks > files ? ranks : files;
+}
+
+static int pawnAttacksSquare(int pawn, int square) {
+    return (square >> 3) == (pawn >> 3) + 1 && abs((square & 7) - (pawn & 7)) == 1;
+}
+
+// King steps from a square, returned in squares[]
+static int kingSteps(int square, int squares[8]) {
+    int count = 0;
+    for (int dr = -1; dr <= 1; dr++) {
+        for (int df = -1; df <= 1; df++) {
+            int rank = (square >> 3) + dr;
+            int file = (square & 7) + df;
+            if ((dr || df) && rank >= 0 && rank < 8 && file >= 0 && file < 8) {
+                squares[count++] = rank * 8 + file;
+            }
+        }
+    }
+    return count;
+}
+
+// The results that follow from the position alone
+static unsigned char classifyInitial(int whiteToMove, int blackKing, int whiteKing, int pawn) {
+    if (distance(whiteKing, blackKing) <= 1 || whiteKing == pawn || blackKing == pawn ||
+        (whiteToMove && pawnAttacksSquare(pawn, blackKing))) {
+        return KPK_INVALID;
+    }
+
+    // The pawn promotes and the new queen cannot be taken
+    int promotion = pawn + 8;
+    if (whiteToMove && (pawn >> 3) == 6 && whiteKing != promotion &&
+        (distance(blackKing, promotion) > 1 || distance(whiteKing, promotion) == 1)) {
+        return KPK_WIN;
+    }
+
+    if (!whiteToMove) {
+        int steps[8];
+        int count = kingSteps(blackKing, steps);
+        int safeSteps = 0;
+        for (int i = 0; i < count; i++) {
+            int guarded = distance(steps[i], whiteKing) <= 1;
+            // An undefended pawn is taken
+            if (steps[i] == pawn && !guarded) return KPK_DRAW;
+            if (!guarded && !pawnAttacksSquare(pawn, steps[i])) safeSteps++;
+        }
+        if (safeSteps == 0) return KPK_DRAW;  // Stalemate (the king is never in check here)
+    }
+    return KPK_UNKNOWN;
+}
+
+// One backward step: a position is decided once any move reaches a good
+// result for the mover, or all moves reach a bad one
+static unsigned char classify(unsigned char* db, int whiteToMove, int blackKing, int whiteKing, int pawn) {
+    unsigned char good = whiteToMove ? KPK_WIN : KPK_DRAW;
+    unsigned char bad = whiteToMove ? KPK_DRAW : KPK_WIN;
+    unsigned char results = KPK_INVALID;
+    int steps[8];
+    int count = kingSteps(whiteToMove ? whiteKing : blackKing, steps);
+
+    for (int i = 0; i < count; i++) {
+        results |= whiteToMove ? db[kpkIndex(0, blackKing, steps[i], pawn)]
+                               : db[kpkIndex(1, steps[i], whiteKing, pawn)];
+    }
+    if (whiteToMove) {
+        // Pushes onto a king land on invalid positions and add nothing
+        if ((pawn >> 3) < 6) {
+            results |= db[kpkIndex(0, blackKing, whiteKing, pawn + 8)];
+        }
+        if ((pawn >> 3) == 1 && pawn + 8 != whiteKing && pawn + 8 != blackKing) {
+            results |= db[kpkIndex(0, blackKing, whiteKing, pawn + 16)];
+        }
+    }
+    return (results & good) ? good : (results & KPK_UNKNOWN) ? KPK_UNKNOWN : bad;
+}
+
+void initBitbase(void) {
+    if (bitbaseInitialized) return;
+
+    unsigned char* db = (unsigned char*)malloc(KPK_POSITIONS);
+    if (db == NULL) return;
+
+    for (int index = 0; index < KPK_POSITIONS; index++) {
+        int whiteKing = index & 63;
+        int blackKing = (index >> 6) & 63;
+        int whiteToMove = !((index >> 12) & 1);
+        int pawn = (6 - ((index >> 15) & 7)) * 8 + ((index >> 13) & 3);
+        db[index] = classifyInitial(whiteToMove, blackKing, whiteKing, pawn);
+    }
+
+    // Iterate until no unknown position can be resolved
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (int index = 0; index < KPK_POSITIONS; index++) {
+            if (db[index] != KPK_UNKNOWN) continue;
+            int whiteKing = index & 63;
+            int blackKing = (index >> 6) & 63;
+            int whiteToMove = !((index >> 12) & 1);
+            int pawn = (6 - ((index >> 15) & 7)) * 8 + ((index >> 13) & 3);
+            db[index] = classify(db, whiteToMove, blackKing, whiteKing, pawn);
+            if (db[index] != KPK_UNKNOWN) changed = 1;
+        }
+    }
+
+    // Whatever is still unknown cannot be forced, so only wins are stored
+    for (int index = 0; index < KPK_POSITIONS; index++) {
+        if (db[index] == KPK_WIN) kpkBits[index / 32] |= 1u << (index & 31);
+    }
+    free(db);
+    bitbaseInitialized = 1;
+}
+
+int probeKPK(int whiteKing, int whitePawn, int blackKing, int whiteToMove) {
+    // Mirror a pawn on the e-h files onto a-d
+    if ((whitePawn & 7) >= 4) {
+        whiteKing ^= 7;
+        whitePawn ^= 7;
+        blackKing ^= 7;
+    }
+    int index = kpkIndex(whiteToMove, blackKing, whiteKing, whitePawn);
+    return (kpkBits[index / 32] >> (index & 31)) & 1;
+}
@@ -0,0 +1,15 @@
+#ifndef BITBASE_H
+#define BITBASE_H
+
+// King and pawn against king, solved by retrograde analysis into one bit per
+// position (win or draw for the pawn's side). Squares here are a1 = 0 .. h8 = 63
+// with the strong side as white; pawns on the e-h files are mirrored onto a-d,
+// leaving 24 pawn squares * 64 * 64 king squares * 2 sides to move.
+
+// Build the table (a few milliseconds); safe to call more than once
+void initBitbase(void);
+
+// 1 if white wins with king, pawn and the given side to move against the black king
+int probeKPK(int whiteKing, int whitePawn, int blackKing, int whiteToMove);
+
+#endif
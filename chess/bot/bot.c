@@ -12,6 +12,8 @@
 #include "evaluation.h"
 #include "moveOrdering.h"
 #include "search.h"
+#include "nnue.h"
+#include "tablebase.h"
 
 // ============================================================================
 // CONFIGURATION
@@ -27,109 +29,169 @@ double BOT_TIME_LIMIT_SECONDS = 0.2;
 #define INITIAL_ALPHA -999999
 #define INITIAL_BETA 999999
 
+// Aspiration windows: half-width around the last depth's score, doubled on
+// every fail-low or fail-high, from this depth on. Past the maximum the
+// failing side opens fully.
+#define ASPIRATION_WINDOW 25
+#define ASPIRATION_MAX_WINDOW 400
+#define ASPIRATION_MIN_DEPTH 4
+
 void setBotDepth(int depth) {
     BOT_TIME_LIMIT_SECONDS = depth * 0.8;
 }
 
 // ============================================================================
-// PROMOTION HANDLING
+// TABLEBASE ROOT PROBE
 // ============================================================================
 
-char chooseBestPromotionPiece(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], GameState* state, 
-                             int startRow, int startCol, int endRow, int endCol, 
-                             int whiteToMove, clock_t startTime) {
-    char piece = board[startRow][startCol];
-    int isWhite = isWhitePiece(piece);
-    
-    char bestPromotion = 'Q';
-    int bestScore = isWhite ? INITIAL_ALPHA : INITIAL_BETA;
-    
-    char promotionPieces[] = {'Q', 'R', 'B', 'N'};
-    int numOptions = 4;
+// With every reply in the tablebases, pick the fastest win, else a draw, else
+// the slowest loss. Returns 0 if some move leaves the loaded endings.
+static int selectTablebaseMove(Position* pos, int whiteToMove, Move* moves, int numMoves, Move* best) {
+    int bestRank = 0;
+    int bestWdl = TB_LOSS, bestPlies = 0;
     
-    for (int i = 0; i < numOptions; i++) {
-        Move testMove = {startRow, startCol, endRow, endCol, promotionPieces[i]};
-        
-        char savedStart, savedEnd, savedCaptured;
-        int wasEnPassant;
-        GameState savedState = *state;
-        int nodesEvaluated = 0;
-        
-        makeMove(board, &testMove, &savedStart, &savedEnd, &savedCaptured, &wasEnPassant, state);
+    for (int i = 0; i < numMoves; i++) {
+        int wdl, plies;
+        doMove(pos, moves[i]);
+        int found = probeTablebaseDTM(pos, !whiteToMove, &wdl, &plies);
+        undoMove(pos);
+        if (!found || wdl == TB_ILLEGAL) return 0;
         
-        int score = evaluatePosition(board, state);
+        // The reply's result is the opponent's; rank ours so that higher is better
+        int ourWdl = (wdl == TB_WIN) ? TB_LOSS : (wdl == TB_LOSS) ? TB_WIN : TB_DRAW;
+        int rank = (ourWdl == TB_WIN) ? 1000 - plies : (ourWdl == TB_DRAW) ? 0 : -1000 + plies;
+        if (i == 0 || rank > bestRank) {
+            bestRank = rank;
+            bestWdl = ourWdl;
+            bestPlies = plies + 1;
+            *best = moves[i];
+        }
+    }
+    
+    if (bestWdl == TB_WIN) {
+        printf("Tablebase: win, mate in %d plies\n", bestPlies);
+    } else if (bestWdl == TB_LOSS) {
+        printf("Tablebase: loss, mated in %d plies\n", bestPlies);
+    } else {
+        printf("Tablebase: draw\n");
+    }
+    return 1;
+}
+
+// ============================================================================
+// ROOT SEARCH
+// ============================================================================
+
+// One principal variation search over the root moves inside (alpha, beta), for
+// the side to move. Returns the best score, alpha itself if no move beat it.
+// A move that fails high stops the pass. *expiredAfter is the number of moves
+// searched when the clock ran out, 0 if it did not.
+static int searchRoot(Position* pos, int whiteToMove, Move* moves, int numMoves, int depth,
+                      int alpha, int beta, Move* bestMove, int* nodesEvaluated,
+                      clock_t startTime, double thinkTime, int* expiredAfter) {
+    *expiredAfter = 0;
+    for (int i = 0; i < numMoves; i++) {
+        doMove(pos, moves[i]);
+        unsigned long long newHash = positionKey(pos, !whiteToMove);
         
-        // FIXED: Remove color bias in promotion evaluation
-        // Only add bonuses based on piece type, not color
-        if (promotionPieces[i] == 'Q') {
-            score += 50;  // Queen is generally best
-        } else if (promotionPieces[i] == 'N') {
-            // Knight promotion can be good in specific tactical situations
-            score += 5;
+        // Only the first move gets the full window
+        int score;
+        if (i == 0) {
+            score = -negamax(pos, depth - 1, -beta, -alpha, 
+                             !whiteToMove, nodesEvaluated, newHash, startTime, 1);
+        } else {
+            score = -negamax(pos, depth - 1, -alpha - 1, -alpha, 
+                             !whiteToMove, nodesEvaluated, newHash, startTime, 1);
+            if (score > alpha && score < beta) {
+                score = -negamax(pos, depth - 1, -beta, -alpha, 
+                                 !whiteToMove, nodesEvaluated, newHash, startTime, 1);
+            }
         }
-        // No bonus for rook/bishop as they're usually worse than queen
         
-        unmakeMove(board, &testMove, savedStart, savedEnd, savedCaptured, wasEnPassant, state);
-        *state = savedState;
+        undoMove(pos);
         
-        if ((isWhite && score > bestScore) || (!isWhite && score < bestScore)) {
-            bestScore = score;
-            bestPromotion = promotionPieces[i];
+        if (score > alpha) {
+            alpha = score;
+            *bestMove = moves[i];
+            
+            // Past the window there is nothing left to learn from this pass;
+            // a forced mate ends the depth and the caller ends the search
+            if (alpha >= beta || score > MATE_SCORE_THRESHOLD) break;
         }
         
         double elapsed = (double)(clock() - startTime) / CLOCKS_PER_SEC;
-        if (elapsed >= BOT_TIME_LIMIT_SECONDS * 0.1) {
+        if (elapsed >= thinkTime) {
+            *expiredAfter = i + 1;
             break;
         }
     }
-    
-    printf("Selected promotion: %c\n", bestPromotion);
-    return bestPromotion;
+    return alpha;
+}
+
+// Move one root move to the front, keeping the order of the others
+static void moveToFront(Move* moves, int numMoves, Move move) {
+    for (int i = 0; i < numMoves; i++) {
+        if (SAME_MOVE(moves[i], move)) {
+            memmove(&moves[1], &moves[0], i * sizeof(Move));
+            moves[0] = move;
+            return;
+        }
+    }
 }
 
 // ============================================================================
 // ITERATIVE DEEPENING + BOT MOVE SELECTION
 // ============================================================================
 
-void selectBotMove(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], int whiteToMove, int* startRow, int* startCol, 
-                   int* endRow, int* endCol, GameState* state, double thinkTime, int currentEval) {
+Move selectBotMove(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], int whiteToMove, GameState* state, 
+                   double thinkTime, int currentEval) {
     
     BOT_TIME_LIMIT_SECONDS = thinkTime;
+    initBitboards();
+    initEvaluation();
     
     if (!initTranspositionTable()) {
         Move moves[MAX_MOVES];
         int numMoves = generateAllLegalMoves(board, whiteToMove, moves, state);
         if (numMoves > 0) {
-            *startRow = moves[0].startRow;
-            *startCol = moves[0].startCol;
-            *endRow = moves[0].endRow;
-            *endCol = moves[0].endCol;
-            
-            char piece = board[*startRow][*startCol];
-            if (toupper(piece) == 'P' && (*endRow == 0 || *endRow == 7)) {
-                printf("Fallback: promoting to queen\n");
+            if (IS_PROMOTION(moves[0])) {
+                printf("Fallback: promoting to %c\n", movePromotionPiece(moves[0]));
             }
-        } else {
-            *startRow = -1;
-            *startCol = -1;
-            *endRow = -1;
-            *endCol = -1;
+            return moves[0];
         }
-        return;
+        return MOVE_NONE;
     }
     
     clearKillerMoves();
+    clearHistory();
+    initSearchTables();
+    resetPawnHashStats();
+    resetEvalCacheStats();
+    resetTablebaseStats();
+    resetPruneStats();
     
-    Move moves[MAX_MOVES];
-    int numMoves = generateAllLegalMoves(board, whiteToMove, moves, state);
+    // The search runs on a bitboard copy; the caller's board is left untouched
+    Position rootPosition;
+    Position* pos = &rootPosition;
+    positionFromBoard(pos, board, state);
+    if (activeEvaluator == EVALUATOR_NNUE) {
+        nnueRefresh(pos);
+    }
+    
+    MoveList list;
+    int numMoves = generateLegalMoves(pos, whiteToMove, &list);
+    Move* moves = list.moves;
     
     if (numMoves == 0) {
-        *startRow = -1;
-        *startCol = -1;
-        *endRow = -1;
-        *endCol = -1;
         freeTranspositionTable();
-        return;
+        return MOVE_NONE;
+    }
+    
+    // Endings in the tablebases are played straight from them
+    Move tablebaseMove = MOVE_NONE;
+    if (selectTablebaseMove(pos, whiteToMove, moves, numMoves, &tablebaseMove)) {
+        freeTranspositionTable();
+        return tablebaseMove;
     }
     
     // ============================================================================
@@ -137,45 +199,33 @@ void selectBotMove(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], int whiteToMove,
     // ============================================================================
     printf("Checking for immediate mates...\n");
     for (int i = 0; i < numMoves; i++) {
-        char savedStart, savedEnd, savedCaptured;
-        int wasEnPassant;
-        GameState savedState = *state;
-        
-        makeMove(board, &moves[i], &savedStart, &savedEnd, &savedCaptured, &wasEnPassant, state);
+        doMove(pos, moves[i]);
         
-        // Check if this move gives immediate mate
-        if (!hasAnyLegalMoves(board, !whiteToMove, state)) {
+        // Check if this move gives immediate mate (in check with no replies)
+        MoveList replies;
+        if (isInCheck(pos, !whiteToMove) && generateLegalMoves(pos, !whiteToMove, &replies) == 0) {
             printf("*** FORCED MATE FOUND! Playing mating move immediately ***\n");
             
-            *startRow = moves[i].startRow;
-            *startCol = moves[i].startCol;
-            *endRow = moves[i].endRow;
-            *endCol = moves[i].endCol;
-            
             // Handle promotion in mating move
-            char piece = board[moves[i].startRow][moves[i].startCol];
-            if (toupper(piece) == 'P' && (moves[i].endRow == 0 || moves[i].endRow == 7)) {
-                if (moves[i].promotionPiece == 0) {
-                    printf("Mating promotion - defaulting to queen\n");
-                } else {
-                    printf("Mating promotion to %c\n", moves[i].promotionPiece);
-                }
+            if (IS_PROMOTION(moves[i])) {
+                printf("Mating promotion to %c\n", movePromotionPiece(moves[i]));
             }
             
-            unmakeMove(board, &moves[i], savedStart, savedEnd, savedCaptured, wasEnPassant, state);
-            *state = savedState;
+            undoMove(pos);
             freeTranspositionTable();
-            return;
+            return moves[i];
         }
         
-        unmakeMove(board, &moves[i], savedStart, savedEnd, savedCaptured, wasEnPassant, state);
-        *state = savedState;
+        undoMove(pos);
     }
     
     Move bestMove = moves[0];
     int bestScore = whiteToMove ? INITIAL_ALPHA : INITIAL_BETA;
     int totalNodesEvaluated = 0;
     int depthReached = 0;
+    int previousScore = 0;
+    int aspirationFailLows = 0;
+    int aspirationFailHighs = 0;
     
     clock_t startTime = clock();
     clock_t lastDepthStartTime = startTime;
@@ -184,6 +234,7 @@ void selectBotMove(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], int whiteToMove,
     printf("\n=== Bot Thinking ===\n");
     printf("Allocated time: %.1f seconds\n", thinkTime);
     printf("Position eval: %d\n", currentEval);
+    printf("Evaluator: %s\n", activeEvaluator == EVALUATOR_NNUE ? "nnue" : "classic");
     printf("Legal moves: %d\n", numMoves);
     
     for (int currentDepth = 1; currentDepth <= 50; currentDepth++) {
@@ -205,85 +256,90 @@ void selectBotMove(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], int whiteToMove,
         
         lastDepthStartTime = clock();
         int depthNodesEvaluated = 0;
-        int depthBestScore = whiteToMove ? INITIAL_ALPHA : INITIAL_BETA;
         Move depthBestMove = moves[0];
         
-        unsigned long long currentHash = computeHash(board);
+        unsigned long long currentHash = positionKey(pos, whiteToMove);
         TTEntry* ttEntry = probeTranspositionTable(currentHash);
-        Move* hashMove = ttEntry ? &ttEntry->bestMove : NULL;
+        Move hashMove = ttEntry ? ttEntry->bestMove : MOVE_NONE;
         
-        sortMoves(board, moves, numMoves, hashMove, 0);
+        sortMoves(pos->board, moves, numMoves, hashMove, 0);
         
-        int completedDepth = 1;
-        for (int i = 0; i < numMoves; i++) {
-            char savedStart, savedEnd, savedCaptured;
-            int wasEnPassant;
-            GameState savedState = *state;
-            
-            makeMove(board, &moves[i], &savedStart, &savedEnd, &savedCaptured, &wasEnPassant, state);
-            updateEnPassant(state, &moves[i], savedStart);
-            unsigned long long newHash = computeHash(board);
-            
-            int score = minimax(board, state, currentDepth - 1, INITIAL_ALPHA, INITIAL_BETA, 
-                               !whiteToMove, &depthNodesEvaluated, newHash, startTime, 1);
-            
-            unmakeMove(board, &moves[i], savedStart, savedEnd, savedCaptured, wasEnPassant, state);
-            *state = savedState;
-            
-            int isBetter = whiteToMove ? (score > depthBestScore) : (score < depthBestScore);
-            if (isBetter) {
-                depthBestScore = score;
-                depthBestMove = moves[i];
-                
-                // Early stopping for clear mates
-                if (whiteToMove && score > MATE_SCORE_THRESHOLD) {
-                    printf("Found winning line at depth %d, stopping search\n", currentDepth);
-                    completedDepth = 0;
-                    break;
-                }
-                if (!whiteToMove && score < -MATE_SCORE_THRESHOLD) {
-                    printf("Found winning line at depth %d, stopping search\n", currentDepth);
-                    completedDepth = 0;
-                    break;
-                }
-            }
-            
-            elapsed = (double)(clock() - startTime) / CLOCKS_PER_SEC;
-            if (elapsed >= thinkTime) {
-                printf("Time expired during depth %d search (after move %d/%d)\n", 
-                       currentDepth, i + 1, numMoves);
-                completedDepth = 0;
-                goto time_expired;
-            }
+        // Scores are for the side to move. From ASPIRATION_MIN_DEPTH the window
+        // starts around the last depth's score and widens on the side that failed.
+        int delta = ASPIRATION_WINDOW;
+        int windowAlpha = INITIAL_ALPHA;
+        int windowBeta = INITIAL_BETA;
+        if (currentDepth >= ASPIRATION_MIN_DEPTH && abs(previousScore) < MATE_SCORE_THRESHOLD) {
+            windowAlpha = previousScore - delta;
+            windowBeta = previousScore + delta;
         }
         
-        if (completedDepth) {
-            bestMove = depthBestMove;
-            bestScore = depthBestScore;
-            totalNodesEvaluated += depthNodesEvaluated;
-            depthReached = currentDepth;
-            
-            lastDepthDuration = (double)(clock() - lastDepthStartTime) / CLOCKS_PER_SEC;
-            elapsed = (double)(clock() - startTime) / CLOCKS_PER_SEC;
-            
-            char promotionInfo[32] = "";
-            if (bestMove.promotionPiece != 0) {
-                snprintf(promotionInfo, sizeof(promotionInfo), " (promote to %c)", bestMove.promotionPiece);
-            }
-            
-            // FIXED: Changed %8%d to %8d in the printf below
-            printf("Depth %2d: score=%6d, nodes=%8d, time=%.2fs%s\n", 
-                   currentDepth, depthBestScore, depthNodesEvaluated, elapsed, promotionInfo);
+        int alpha;
+        int researches = 0;
+        int expiredAfter;
+        while (1) {
+            alpha = searchRoot(pos, whiteToMove, moves, numMoves, currentDepth,
+                               windowAlpha, windowBeta, &depthBestMove, &depthNodesEvaluated,
+                               startTime, thinkTime, &expiredAfter);
+            if (expiredAfter) break;
             
-            // Early stopping for clear winning positions
-            if (whiteToMove && depthBestScore > MATE_SCORE_THRESHOLD) {
-                printf("Found winning line, stopping search\n");
-                break;
-            }
-            if (!whiteToMove && depthBestScore < -MATE_SCORE_THRESHOLD) {
-                printf("Found winning line, stopping search\n");
+            if (alpha <= windowAlpha && windowAlpha > INITIAL_ALPHA) {
+                windowAlpha = (delta >= ASPIRATION_MAX_WINDOW) ? INITIAL_ALPHA : windowAlpha - delta;
+                aspirationFailLows++;
+            } else if (alpha >= windowBeta && windowBeta < INITIAL_BETA) {
+                windowBeta = (delta >= ASPIRATION_MAX_WINDOW) ? INITIAL_BETA : windowBeta + delta;
+                aspirationFailHighs++;
+                
+                // The refuting move is searched first next time
+                moveToFront(moves, numMoves, depthBestMove);
+            } else {
                 break;
             }
+            delta *= 2;
+            researches++;
+        }
+        
+        if (expiredAfter) {
+            printf("Time expired during depth %d search (after move %d/%d)\n", 
+                   currentDepth, expiredAfter, numMoves);
+            goto time_expired;
+        }
+        
+        // The root's best move leads the ordering at the next depth
+        storeTranspositionTable(currentHash, currentDepth, alpha, TT_EXACT, depthBestMove);
+        
+        int depthBestScore = whiteToMove ? alpha : -alpha;
+        previousScore = alpha;
+        bestMove = depthBestMove;
+        bestScore = depthBestScore;
+        totalNodesEvaluated += depthNodesEvaluated;
+        depthReached = currentDepth;
+        
+        lastDepthDuration = (double)(clock() - lastDepthStartTime) / CLOCKS_PER_SEC;
+        elapsed = (double)(clock() - startTime) / CLOCKS_PER_SEC;
+        
+        char promotionInfo[32] = "";
+        if (IS_PROMOTION(bestMove)) {
+            snprintf(promotionInfo, sizeof(promotionInfo), " (promote to %c)", movePromotionPiece(bestMove));
+        }
+        
+        char researchInfo[32] = "";
+        if (researches > 0) {
+            snprintf(researchInfo, sizeof(researchInfo), ", re-searches=%d", researches);
+        }
+        
+        // FIXED: Changed %8%d to %8d in the printf below
+        printf("Depth %2d: score=%6d, nodes=%8d, time=%.2fs%s%s\n", 
+               currentDepth, depthBestScore, depthNodesEvaluated, elapsed, researchInfo, promotionInfo);
+        
+        // Early stopping for clear winning positions
+        if (whiteToMove && depthBestScore > MATE_SCORE_THRESHOLD) {
+            printf("Found winning line, stopping search\n");
+            break;
+        }
+        if (!whiteToMove && depthBestScore < -MATE_SCORE_THRESHOLD) {
+            printf("Found winning line, stopping search\n");
+            break;
         }
     }
 
@@ -293,40 +349,54 @@ void selectBotMove(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], int whiteToMove,
     
     totalTime = (double)(clock() - startTime) / CLOCKS_PER_SEC;
     
-    // PROMOTION HANDLING
-    char piece = board[bestMove.startRow][bestMove.startCol];
-    int isPromotion = (toupper(piece) == 'P') && 
-                     ((isWhitePiece(piece) && bestMove.endRow == 0) || 
-                      (!isWhitePiece(piece) && bestMove.endRow == 7));
-    
-    if (isPromotion && bestMove.promotionPiece == 0) {
-        printf("Choosing best promotion piece...\n");
-        bestMove.promotionPiece = chooseBestPromotionPiece(board, state, 
-                                                          bestMove.startRow, bestMove.startCol,
-                                                          bestMove.endRow, bestMove.endCol,
-                                                          whiteToMove, startTime);
-    }
-    
     printf("\n=== Search Complete ===\n");
     printf("Maximum depth reached: %d\n", depthReached);
     printf("Total nodes evaluated: %d\n", totalNodesEvaluated);
     printf("Nodes per second: %.0f\n", totalNodesEvaluated / (totalTime > 0 ? totalTime : 0.001));
     printf("Total time: %.2f seconds\n", totalTime);
     printf("Best move score: %d\n", bestScore);
+    printf("Aspiration re-searches: %d (%d fail-low, %d fail-high)\n", 
+           aspirationFailLows + aspirationFailHighs, aspirationFailLows, aspirationFailHighs);
+    
+    unsigned long long pawnProbes, pawnHits;
+    getPawnHashStats(&pawnProbes, &pawnHits);
+    printf("Pawn hash: %llu/%llu hits (%.1f%%)\n", pawnHits, pawnProbes, 
+           pawnProbes ? 100.0 * pawnHits / pawnProbes : 0.0);
+    
+    unsigned long long evalProbes, evalHits;
+    getEvalCacheStats(&evalProbes, &evalHits);
+    printf("Eval cache: %llu/%llu hits, %llu misses (%.1f%%)\n", evalHits, evalProbes, 
+           evalProbes - evalHits, evalProbes ? 100.0 * evalHits / evalProbes : 0.0);
+    
+    PruneStats prune;
+    getPruneStats(&prune);
+    printf("Pruned: reverse futility %llu, futility %llu, razoring %llu, null move %llu, late move %llu\n",
+           prune.reverseFutility, prune.futility, prune.razoring, prune.nullMove, prune.lateMove);
+    printf("Quiescence: %llu losing captures skipped by SEE\n", prune.badCaptures);
     
-    if (bestMove.promotionPiece != 0) {
+    unsigned long long tbProbes, tbHits, tbNanoseconds;
+    getTablebaseStats(&tbProbes, &tbHits, &tbNanoseconds);
+    if (tbProbes > 0) {
+        printf("Tablebase: %llu/%llu hits, %.0f ns per hit\n", tbHits, tbProbes,
+               tbHits ? (double)tbNanoseconds / tbHits : 0.0);
+    }
+    
+    int startRow, startCol, endRow, endCol;
+    moveToCoordinates(bestMove, &startRow, &startCol, &endRow, &endCol);
+    
+    if (IS_PROMOTION(bestMove)) {
         printf("Selected move: %c%d -> %c%d (promote to %c)\n", 
-               'a' + bestMove.startCol, MAX_BOARD_SIZE - bestMove.startRow,
-               'a' + bestMove.endCol, MAX_BOARD_SIZE - bestMove.endRow,
-               bestMove.promotionPiece);
+               'a' + startCol, MAX_BOARD_SIZE - startRow,
+               'a' + endCol, MAX_BOARD_SIZE - endRow,
+               movePromotionPiece(bestMove));
     } else {
         printf("Selected move: %c%d -> %c%d\n", 
-               'a' + bestMove.startCol, MAX_BOARD_SIZE - bestMove.startRow,
-               'a' + bestMove.endCol, MAX_BOARD_SIZE - bestMove.endRow);
+               'a' + startCol, MAX_BOARD_SIZE - startRow,
+               'a' + endCol, MAX_BOARD_SIZE - endRow);
     }
     
-    if (toupper(piece) == 'K' && abs(bestMove.endCol - bestMove.startCol) == 2) {
-        if (bestMove.endCol > bestMove.startCol) {
+    if (MOVE_FLAGS(bestMove) == MOVE_CASTLE) {
+        if (endCol > startCol) {
             printf("Castling: kingside\n");
         } else {
             printf("Castling: queenside\n");
@@ -335,17 +405,12 @@ void selectBotMove(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], int whiteToMove,
     
     printf("===================\n\n");
     
-    *startRow = bestMove.startRow;
-    *startCol = bestMove.startCol;
-    *endRow = bestMove.endRow;
-    *endCol = bestMove.endCol;
-    
     freeTranspositionTable();
+    return bestMove;
 }
 
 // CHANGED: Remove the hardcoded 5.0 seconds - let main.c handle the default
-void getBotMove(char board[8][8], int whiteToMove, int* startRow, int* startCol, 
-                int* endRow, int* endCol, GameState* state) {
+Move getBotMove(char board[8][8], int whiteToMove, GameState* state) {
     // Use a reasonable fallback, but main.c should provide the configured value
-    selectBotMove(board, whiteToMove, startRow, startCol, endRow, endCol, state, 2.0, 0);
+    return selectBotMove(board, whiteToMove, state, 2.0, 0);
 }
\ No newline at end of file
@@ -2,17 +2,18 @@
 #define BOT_H
 
 #include "gameState.h"
+#include "moves.h"
 
 typedef struct {
     int autoPlay;
     double defaultThinkTime;  // Default thinking time when no time control
 } BotSettings;
 
-// Function declarations
-void selectBotMove(char board[8][8], int whiteToMove, int* startRow, int* startCol, 
-                   int* endRow, int* endCol, GameState* state, double thinkTime, int currentEval);
-void getBotMove(char board[8][8], int whiteToMove, int* startRow, int* startCol, 
-                int* endRow, int* endCol, GameState* state);
+// Function declarations. The chosen move is returned packed, MOVE_NONE if there is none;
+// main.c decodes it with moveToCoordinates() and movePromotionPiece().
+Move selectBotMove(char board[8][8], int whiteToMove, GameState* state, 
+                   double thinkTime, int currentEval);
+Move getBotMove(char board[8][8], int whiteToMove, GameState* state);
 void setBotDepth(int depth);
 
 #endif
\ No newline at end of file
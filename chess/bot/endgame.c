@@ -0,0 +1,234 @@
+#include <stdlib.h>
+#include <string.h>
+#include <endgame.h>
+#include <bitbase.h>
+#include <board.h>
+
+// Non-pawn material in centipawns, for the scaling rules
+static const int pieceMaterial[6] = {0, 325, 325, 500, 975, 0};
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+static int squareDistance(int a, int b) {
+    int rows = abs(SQUARE_ROW(a) - SQUARE_ROW(b));
+    int cols = abs(SQUARE_COL(a) - SQUARE_COL(b));
+    return rows > cols ? rows : cols;
+}
+
+// 0 on the edge, 3 in the center
+static int edgeDistance(int square) {
+    int row = SQUARE_ROW(square);
+    int col = SQUARE_COL(square);
+    int rowEdge = row < 7 - row ? row : 7 - row;
+    int colEdge = col < 7 - col ? col : 7 - col;
+    return rowEdge < colEdge ? rowEdge : colEdge;
+}
+
+static int nonPawnMaterial(Position* pos, int color) {
+    int material = 0;
+    for (int type = KNIGHT; type <= QUEEN; type++) {
+        material += pos->pieceCount[PIECE_INDEX(color, type)] * pieceMaterial[type];
+    }
+    return material;
+}
+
+// Drive the lone king to the edge and bring the attacking king closer
+static int matingNet(Position* pos, int strong) {
+    int strongKing = pos->kingSquare[strong];
+    int weakKing = pos->kingSquare[!strong];
+    return 40 * (3 - edgeDistance(weakKing)) + 10 * (7 - squareDistance(strongKing, weakKing));
+}
+
+// ============================================================================
+// SPECIALIZED EVALUATORS
+// ============================================================================
+
+// Each returns 1 and a score for the strong side when it knows the result
+
+static int evaluateDrawn(Position* pos, int strong, int* score) {
+    (void)pos;
+    (void)strong;
+    *score = 0;
+    return 1;
+}
+
+// King and queen or rook against a bare king
+static int evaluateKXK(Position* pos, int strong, int* score) {
+    *score = KNOWN_WIN + nonPawnMaterial(pos, strong) + matingNet(pos, strong);
+    return 1;
+}
+
+// King, bishop and knight: the mate only works in a corner of the bishop's color
+static int evaluateKBNK(Position* pos, int strong, int* score) {
+    int bishop = pos->pieceList[PIECE_INDEX(strong, BISHOP)][0];
+    int weakKing = pos->kingSquare[!strong];
+    int bishopColor = (SQUARE_ROW(bishop) + SQUARE_COL(bishop)) & 1;
+
+    // a8 and h1 share a color, h8 and a1 the other
+    int cornerA = bishopColor ? SQUARE(0, 7) : SQUARE(0, 0);
+    int cornerB = bishopColor ? SQUARE(7, 0) : SQUARE(7, 7);
+    int toCornerA = squareDistance(weakKing, cornerA);
+    int toCornerB = squareDistance(weakKing, cornerB);
+    int cornerDistance = toCornerA < toCornerB ? toCornerA : toCornerB;
+
+    *score = KNOWN_WIN + nonPawnMaterial(pos, strong) + 60 * (7 - cornerDistance) +
+             10 * (7 - squareDistance(pos->kingSquare[strong], weakKing));
+    return 1;
+}
+
+// King and pawn, looked up in the bitbase (strong side seen as white)
+static int kpkWins(Position* pos, int strong, int strongToMove) {
+    int flip = (strong == COLOR_WHITE) ? 56 : 0;
+    int pawn = pos->pieceList[PIECE_INDEX(strong, PAWN)][0];
+    return probeKPK(pos->kingSquare[strong] ^ flip, pawn ^ flip,
+                    pos->kingSquare[!strong] ^ flip, strongToMove);
+}
+
+// A won KPK ending, better the further the pawn and the closer its king
+static int kpkWinScore(Position* pos, int strong) {
+    int pawn = pos->pieceList[PIECE_INDEX(strong, PAWN)][0];
+    int promotionRow = (strong == COLOR_WHITE) ? 0 : 7;
+    int queening = SQUARE(promotionRow, SQUARE_COL(pawn));
+    return KNOWN_WIN + 20 * (7 - abs(SQUARE_ROW(pawn) - promotionRow)) +
+           2 * (7 - squareDistance(pos->kingSquare[strong], queening));
+}
+
+// The static evaluation has no side to move, so only results that hold
+// either way are settled here; the search probes the rest exactly
+static int evaluateKPK(Position* pos, int strong, int* score) {
+    int winsToMove = kpkWins(pos, strong, 1);
+    int winsNotToMove = kpkWins(pos, strong, 0);
+    if (winsToMove && winsNotToMove) {
+        *score = kpkWinScore(pos, strong);
+        return 1;
+    }
+    if (!winsToMove && !winsNotToMove) {
+        *score = 0;
+        return 1;
+    }
+    return 0;
+}
+
+// ============================================================================
+// MATERIAL SIGNATURE TABLE
+// ============================================================================
+
+typedef int (*EndgameFunction)(Position* pos, int strong, int* score);
+
+typedef struct {
+    unsigned long long key;
+    EndgameFunction evaluate;
+    int strong;
+} EndgameEntry;
+
+#define ENDGAME_TABLE_SIZE 64  // Power of two, well above the entries registered
+
+static EndgameEntry endgameTable[ENDGAME_TABLE_SIZE];
+static unsigned long long kpkKeys[2];  // Per strong side
+static int endgamesInitialized = 0;
+
+// Key of a signature such as "KRK": the strong side's pieces, then the weak side's
+static unsigned long long signatureKey(const char* code, int strong) {
+    int counts[NUM_PIECE_TYPES] = {0};
+    int color = strong;
+    for (int i = 0; code[i]; i++) {
+        if (code[i] == 'K' && i > 0) color = !strong;
+        const char* types = "PNBRQK";
+        int type = (int)(strchr(types, code[i]) - types);
+        counts[PIECE_INDEX(color, type)]++;
+    }
+    return materialKeyOf(counts);
+}
+
+static void addEndgame(const char* code, EndgameFunction evaluate) {
+    for (int strong = COLOR_WHITE; strong <= COLOR_BLACK; strong++) {
+        unsigned long long key = signatureKey(code, strong);
+        int slot = key & (ENDGAME_TABLE_SIZE - 1);
+        while (endgameTable[slot].key != 0 && endgameTable[slot].key != key) {
+            slot = (slot + 1) & (ENDGAME_TABLE_SIZE - 1);
+        }
+        endgameTable[slot].key = key;
+        endgameTable[slot].evaluate = evaluate;
+        endgameTable[slot].strong = strong;
+    }
+}
+
+void initEndgames(void) {
+    if (endgamesInitialized) return;
+    initZobrist();
+
+    // Dead draws: nothing can force mate
+    addEndgame("KK", evaluateDrawn);
+    addEndgame("KNK", evaluateDrawn);
+    addEndgame("KBK", evaluateDrawn);
+    addEndgame("KNNK", evaluateDrawn);
+    addEndgame("KNKN", evaluateDrawn);
+    addEndgame("KBKN", evaluateDrawn);
+    addEndgame("KBKB", evaluateDrawn);
+
+    // Known wins
+    addEndgame("KQK", evaluateKXK);
+    addEndgame("KRK", evaluateKXK);
+    addEndgame("KBNK", evaluateKBNK);
+    addEndgame("KPK", evaluateKPK);
+    kpkKeys[COLOR_WHITE] = signatureKey("KPK", COLOR_WHITE);
+    kpkKeys[COLOR_BLACK] = signatureKey("KPK", COLOR_BLACK);
+    initBitbase();
+    endgamesInitialized = 1;
+}
+
+int probeEndgame(Position* pos, int* score) {
+    int slot = pos->materialKey & (ENDGAME_TABLE_SIZE - 1);
+    while (endgameTable[slot].key != 0) {
+        EndgameEntry* entry = &endgameTable[slot];
+        if (entry->key == pos->materialKey) {
+            if (!entry->evaluate(pos, entry->strong, score)) return 0;
+            if (entry->strong == COLOR_BLACK) *score = -*score;
+            return 1;
+        }
+        slot = (slot + 1) & (ENDGAME_TABLE_SIZE - 1);
+    }
+    return 0;
+}
+
+int probeKnownEnding(Position* pos, int whiteToMove, int* score) {
+    for (int strong = COLOR_WHITE; strong <= COLOR_BLACK; strong++) {
+        if (pos->materialKey == kpkKeys[strong]) {
+            int strongToMove = whiteToMove == (strong == COLOR_WHITE);
+            *score = kpkWins(pos, strong, strongToMove) ? kpkWinScore(pos, strong) : 0;
+            if (strong == COLOR_BLACK) *score = -*score;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// ============================================================================
+// SCALE FACTORS
+// ============================================================================
+
+int endgameScale(Position* pos, int strongColor) {
+    int weakColor = !strongColor;
+    int strongMaterial = nonPawnMaterial(pos, strongColor);
+    int weakMaterial = nonPawnMaterial(pos, weakColor);
+
+    // Without pawns, being up a minor piece or less rarely wins (KRKB, KRKN)
+    if (pos->pieceCount[PIECE_INDEX(strongColor, PAWN)] == 0 &&
+        strongMaterial - weakMaterial <= pieceMaterial[BISHOP]) {
+        return strongMaterial < pieceMaterial[ROOK] ? SCALE_DRAW : SCALE_NORMAL / 4;
+    }
+
+    // Opposite-colored bishops with only pawns besides are very drawish
+    if (strongMaterial == pieceMaterial[BISHOP] && weakMaterial == pieceMaterial[BISHOP] &&
+        pos->pieceCount[PIECE_INDEX(strongColor, BISHOP)] == 1 &&
+        pos->pieceCount[PIECE_INDEX(weakColor, BISHOP)] == 1) {
+        int a = pos->pieceList[PIECE_INDEX(strongColor, BISHOP)][0];
+        int b = pos->pieceList[PIECE_INDEX(weakColor, BISHOP)][0];
+        if (((SQUARE_ROW(a) + SQUARE_COL(a)) & 1) != ((SQUARE_ROW(b) + SQUARE_COL(b)) & 1)) {
+            return SCALE_NORMAL * 3 / 8;
+        }
+    }
+    return SCALE_NORMAL;
+}
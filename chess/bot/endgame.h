@@ -0,0 +1,28 @@
+#ifndef ENDGAME_H
+#define ENDGAME_H
+
+#include <position.h>
+
+// Score of a won ending, well clear of any material balance but below mates
+#define KNOWN_WIN 10000
+
+// Endgame scale factors: the endgame score is multiplied by scale / SCALE_NORMAL
+#define SCALE_NORMAL 64
+#define SCALE_DRAW 0
+
+// Register the known material signatures and build the KPK bitbase; needs the
+// Zobrist keys, safe to call more than once
+void initEndgames(void);
+
+// If the position's material has a specialized evaluator, store its score
+// (white's point of view) and return 1
+int probeEndgame(Position* pos, int* score);
+
+// Exact result of a bitbase ending (KPK) with the side to move known, for the
+// search; 1 and a score from white's point of view if the material matches
+int probeKnownEnding(Position* pos, int whiteToMove, int* score);
+
+// Scale for the endgame score of the side that is ahead
+int endgameScale(Position* pos, int strongColor);
+
+#endif
@@ -1,11 +1,45 @@
 #ifndef EVALUATION_H
 #define EVALUATION_H
 #include "gameState.h"
+#include <position.h>
 
 // Constants for magic numbers
 #define MAX_BOARD_SIZE 8
 #define MATE_SCORE 100000
+#define PAWN_HASH_SIZE 16384  // Entries, a power of two (16 bytes each)
+#define EVAL_CACHE_DEFAULT_SIZE 262144  // Entries (8 bytes each, 2MB)
+
+// Evaluators selectable at runtime
+#define EVALUATOR_CLASSIC 0  // Hand-written PeSTO terms
+#define EVALUATOR_NNUE 1     // Network from loadNnue() (see nnue.h)
+
+extern int activeEvaluator;
+
+// Switch evaluator; 0 if the network is asked for but none is loaded
+int setEvaluator(int evaluator);
+
+// Fill the position's piece-square tables; must run before positions are built
+void initEvaluation(void);
+
+// Pawn hash usage since the last reset, for sizing PAWN_HASH_SIZE
+void getPawnHashStats(unsigned long long* probes, unsigned long long* hits);
+void resetPawnHashStats(void);
 
 int evaluatePosition(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], GameState* state);
 
+// Same evaluation on a search position, walking its piece lists (white's point of view).
+// Scores are cached by position hash.
+int evaluate(Position* pos);
+
+// Attack maps built by the last full evaluation of this position, NULL if the
+// score came from the cache, the network or a specialized ending
+const AttackMaps* lastAttackMaps(Position* pos);
+
+// Resize the evaluation cache (rounded down to a power of two); 0 if allocation failed
+int setEvalCacheSize(int entries);
+
+// Evaluation cache usage since the last reset
+void getEvalCacheStats(unsigned long long* probes, unsigned long long* hits);
+void resetEvalCacheStats(void);
+
 #endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <string.h>
 #include <moves.h>
 #include <board.h> 
+#include <evaluation.h>
 
 #define SCORE_TT_MOVE 1000000
 #define SCORE_CAPTURE_BASE 100000
@@ -18,65 +19,137 @@ void clearKillerMoves(void) {
     memset(killerMoves, 0, sizeof(killerMoves));
 }
 
-void storeKillerMove(Move* move, int depth) {
+void storeKillerMove(Move move, int depth) {
     if (depth >= MAX_DEPTH) return;
     
     // Don't store if it's already the first killer
-    if (killerMoves[depth][0].startRow == move->startRow &&
-        killerMoves[depth][0].startCol == move->startCol &&
-        killerMoves[depth][0].endRow == move->endRow &&
-        killerMoves[depth][0].endCol == move->endCol) {
+    if (SAME_MOVE(killerMoves[depth][0], move)) {
         return;
     }
     
     // Shift and store
     killerMoves[depth][1] = killerMoves[depth][0];
-    killerMoves[depth][0] = *move;
+    killerMoves[depth][0] = move;
 }
 
-int isKillerMove(Move* move, int depth) {
+int isKillerMove(Move move, int depth) {
     if (depth >= MAX_DEPTH) return 0;
     
-    for (int i = 0; i < KILLERS_PER_DEPTH; i++) {
-        if (killerMoves[depth][i].startRow == move->startRow &&
-            killerMoves[depth][i].startCol == move->startCol &&
-            killerMoves[depth][i].endRow == move->endRow &&
-            killerMoves[depth][i].endCol == move->endCol) {
-            return 1;
-        }
-    }
-    return 0;
+    return SAME_MOVE(killerMoves[depth][0], move) || SAME_MOVE(killerMoves[depth][1], move);
+}
+
+// History scores by side, from square and to square
+static int historyTable[2][NUM_SQUARES][NUM_SQUARES];
+
+void clearHistory(void) {
+    memset(historyTable, 0, sizeof(historyTable));
+}
+
+void updateHistory(int whiteToMove, Move move, int bonus) {
+    int* entry = &historyTable[whiteToMove ? 0 : 1][MOVE_FROM(move)][MOVE_TO(move)];
+    if (bonus > HISTORY_MAX) bonus = HISTORY_MAX;
+    if (bonus < -HISTORY_MAX) bonus = -HISTORY_MAX;
+    
+    // Moves toward the bound by a shrinking step, so the score never leaves it
+    *entry += bonus - *entry * abs(bonus) / HISTORY_MAX;
+}
+
+int getHistoryScore(int whiteToMove, Move move) {
+    return historyTable[whiteToMove ? 0 : 1][MOVE_FROM(move)][MOVE_TO(move)];
 }
 
 int getCaptureValue(char capturedPiece) {
-    if (isEmpty(capturedPiece)) return 0;
+    static const int values[6] = {1, 3, 3, 5, 9, 100};  // P, N, B, R, Q, K
+    int index = pieceIndex(capturedPiece);
+    return index == PIECE_NONE ? 0 : values[index % 6];
+}
+
+// ============================================================================
+// STATIC EXCHANGE EVALUATION
+// ============================================================================
+
+static const int seeValues[6] = {100, 320, 330, 500, 900, 20000};  // P, N, B, R, Q, K
+
+// Swap algorithm: both sides keep recapturing on the target square with their
+// least valuable attacker, sliders behind a capturer join in as the occupancy
+// is updated, and either side may stop when going on would lose. Pins are ignored.
+int staticExchange(Position* pos, Move move) {
+    int from = MOVE_FROM(move);
+    int to = MOVE_TO(move);
+    int flags = MOVE_FLAGS(move);
+    if (flags == MOVE_CASTLE) return 0;
     
-    int values[256] = {0};
-    values['P'] = 1; values['p'] = 1;
-    values['N'] = 3; values['n'] = 3;
-    values['B'] = 3; values['b'] = 3;
-    values['R'] = 5; values['r'] = 5;
-    values['Q'] = 9; values['q'] = 9;
-    values['K'] = 100; values['k'] = 100;
+    int mover = pieceIndex(pos->board[SQUARE_ROW(from)][SQUARE_COL(from)]);
+    int side = mover / 6;
+    int attacker = mover % 6;
+    Bitboard occupied = pos->occupied ^ SQUARE_BB(from);
     
-    return values[(int)capturedPiece];
+    int gain[32];
+    int depth = 0;
+    if (flags == MOVE_EN_PASSANT) {
+        gain[0] = seeValues[PAWN];
+        occupied ^= SQUARE_BB(SQUARE(SQUARE_ROW(from), SQUARE_COL(to)));
+    } else {
+        int captured = pieceIndex(pos->board[SQUARE_ROW(to)][SQUARE_COL(to)]);
+        gain[0] = (captured == PIECE_NONE) ? 0 : seeValues[captured % 6];
+    }
+    if (IS_PROMOTION(move)) {
+        attacker = PROMOTION_TYPE(move);
+        gain[0] += seeValues[attacker] - seeValues[PAWN];
+    }
+    
+    Bitboard* p = pos->pieces;
+    Bitboard bishopsQueens = p[PIECE_INDEX(COLOR_WHITE, BISHOP)] | p[PIECE_INDEX(COLOR_BLACK, BISHOP)] |
+                             p[PIECE_INDEX(COLOR_WHITE, QUEEN)] | p[PIECE_INDEX(COLOR_BLACK, QUEEN)];
+    Bitboard rooksQueens = p[PIECE_INDEX(COLOR_WHITE, ROOK)] | p[PIECE_INDEX(COLOR_BLACK, ROOK)] |
+                           p[PIECE_INDEX(COLOR_WHITE, QUEEN)] | p[PIECE_INDEX(COLOR_BLACK, QUEEN)];
+    Bitboard attackers = attackersTo(pos, to, occupied) & occupied;
+    Bitboard fromSet = 0;
+    
+    do {
+        // The piece now on the square would be taken next (speculative entry)
+        depth++;
+        gain[depth] = seeValues[attacker] - gain[depth - 1];
+        if ((-gain[depth - 1] > gain[depth] ? -gain[depth - 1] : gain[depth]) < 0) break;
+        
+        // Sliders lined up behind the last capturer join in
+        attackers |= (bishopAttacks(to, occupied) & bishopsQueens) | (rookAttacks(to, occupied) & rooksQueens);
+        attackers &= occupied;
+        
+        // The other side's least valuable attacker makes that capture
+        side = !side;
+        fromSet = 0;
+        for (attacker = PAWN; attacker <= KING; attacker++) {
+            fromSet = attackers & p[PIECE_INDEX(side, attacker)];
+            if (fromSet) break;
+        }
+        fromSet &= 0 - fromSet;
+        occupied ^= fromSet;
+    } while (fromSet && depth < 31);
+    
+    // Back up, dropping the last speculative entry: each side chooses between
+    // stopping and the exchange that follows
+    while (--depth) {
+        gain[depth - 1] = -(-gain[depth - 1] > gain[depth] ? -gain[depth - 1] : gain[depth]);
+    }
+    return gain[0];
 }
 
 // Improved move scoring for ordering
-int scoreMoveForOrdering(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Move* move, Move* hashMove, int depth) {
+int scoreMoveForOrdering(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Move move, Move hashMove, int depth) {
     int score = 0;
     
     // 1. Hash move gets highest priority (from transposition table)
-    if (hashMove && 
-        move->startRow == hashMove->startRow &&
-        move->startCol == hashMove->startCol &&
-        move->endRow == hashMove->endRow &&
-        move->endCol == hashMove->endCol) {
+    if (hashMove != MOVE_NONE && SAME_MOVE(move, hashMove)) {
         return SCORE_TT_MOVE;
     }
     
-    char movingPiece = board[move->startRow][move->startCol];
-    char targetPiece = board[move->endRow][move->endCol];
+    int from = MOVE_FROM(move);
+    int to = MOVE_TO(move);
+    int endRow = SQUARE_ROW(to);
+    int endCol = SQUARE_COL(to);
+    char movingPiece = board[SQUARE_ROW(from)][SQUARE_COL(from)];
+    char targetPiece = board[endRow][endCol];
     
     // 2. Captures using MVV-LVA (Most Valuable Victim - Least Valuable Attacker)
     if (!isEmpty(targetPiece)) {
@@ -88,11 +161,9 @@ int scoreMoveForOrdering(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Move* move,
     
     // Quiet moves below
     
-    // 3. Promotions (assuming to queen, detect by pawn to back rank)
-    // Assuming row 0 is rank 8 (black's back), row 7 is rank 1 (white's back)
-    if ((movingPiece == 'P' && move->endRow == 0) || 
-        (movingPiece == 'p' && move->endRow == MAX_BOARD_SIZE - 1)) {
-        return SCORE_PROMOTION;
+    // 3. Promotions, queen first
+    if (IS_PROMOTION(move)) {
+        return SCORE_PROMOTION + PROMOTION_TYPE(move);
     }
     
     // 4. Killer moves
@@ -101,17 +172,15 @@ int scoreMoveForOrdering(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Move* move,
     }
     
     // 5. Castling
-    if ((movingPiece == 'K' || movingPiece == 'k') &&
-        abs(move->endCol - move->startCol) == 2 &&
-        move->startRow == move->endRow) {
+    if (MOVE_FLAGS(move) == MOVE_CASTLE) {
         score = SCORE_CASTLING;
     }
     
     // 6. Center control moves
     int centerStart = (MAX_BOARD_SIZE / 2) - 1;
     int centerEnd = centerStart + 1;
-    if ((move->endRow >= centerStart && move->endRow <= centerEnd) && 
-        (move->endCol >= centerStart && move->endCol <= centerEnd)) {
+    if ((endRow >= centerStart && endRow <= centerEnd) && 
+        (endCol >= centerStart && endCol <= centerEnd)) {
         score += SCORE_CENTER;
     }
     
@@ -128,14 +197,14 @@ static int compareScoredMoves(const void* a, const void* b) {
 }
 
 // Sort moves by score
-void sortMoves(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Move* moves, int numMoves, Move* hashMove, int depth) {
+void sortMoves(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Move* moves, int numMoves, Move hashMove, int depth) {
     if (numMoves <= 1) return;
     
     ScoredMove scoredMoves[MAX_MOVES];
     
     for (int i = 0; i < numMoves; i++) {
         scoredMoves[i].move = moves[i];
-        scoredMoves[i].score = scoreMoveForOrdering(board, &moves[i], hashMove, depth);
+        scoredMoves[i].score = scoreMoveForOrdering(board, moves[i], hashMove, depth);
     }
     
     qsort(scoredMoves, numMoves, sizeof(ScoredMove), compareScoredMoves);
@@ -143,4 +212,174 @@ void sortMoves(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Move* moves, int numM
     for (int i = 0; i < numMoves; i++) {
         moves[i] = scoredMoves[i].move;
     }
-}
\ No newline at end of file
+}
+// ============================================================================
+// STAGED MOVE PICKER
+// ============================================================================
+
+enum {
+    STAGE_HASH,
+    STAGE_GEN_CAPTURES,
+    STAGE_CAPTURES,
+    STAGE_KILLERS,
+    STAGE_GEN_QUIETS,
+    STAGE_QUIETS,
+    STAGE_BAD_CAPTURES,
+    STAGE_DONE
+};
+
+void initMovePicker(MovePicker* picker, Position* pos, int whiteToMove, Move hashMove, int ply) {
+    picker->pos = pos;
+    picker->whiteToMove = whiteToMove;
+    picker->ply = ply;
+    picker->stage = STAGE_HASH;
+    picker->capturesOnly = 0;
+    picker->index = 0;
+    picker->list.count = 0;
+    picker->numBadCaptures = 0;
+    picker->badCapturesSkipped = 0;
+    
+    // TT moves can come from a hash collision, so check them before use
+    picker->hashMove = isLegalMoveInPosition(pos, whiteToMove, hashMove) ? hashMove : MOVE_NONE;
+    
+    for (int i = 0; i < KILLERS_PER_DEPTH; i++) {
+        picker->killers[i] = (ply < MAX_DEPTH) ? killerMoves[ply][i] : MOVE_NONE;
+    }
+}
+
+// Quiescence picker: captures and promotions only, no hash move or killers
+void initCapturePicker(MovePicker* picker, Position* pos, int whiteToMove) {
+    picker->pos = pos;
+    picker->whiteToMove = whiteToMove;
+    picker->ply = 0;
+    picker->stage = STAGE_GEN_CAPTURES;
+    picker->capturesOnly = 1;
+    picker->index = 0;
+    picker->list.count = 0;
+    picker->numBadCaptures = 0;
+    picker->badCapturesSkipped = 0;
+    picker->hashMove = MOVE_NONE;
+}
+
+// Score the generated moves of the current stage; quiets add their history
+static void scorePickerMoves(MovePicker* picker) {
+    for (int i = 0; i < picker->list.count; i++) {
+        Move move = picker->list.moves[i];
+        picker->scores[i] = scoreMoveForOrdering(picker->pos->board, move, MOVE_NONE, picker->ply);
+        if (picker->stage == STAGE_GEN_QUIETS && !IS_PROMOTION(move)) {
+            picker->scores[i] += getHistoryScore(picker->whiteToMove, move);
+        }
+    }
+    picker->index = 0;
+}
+
+// Selection step: swap the best remaining move to the front and return it
+static Move pickBest(MovePicker* picker) {
+    int best = picker->index;
+    for (int i = picker->index + 1; i < picker->list.count; i++) {
+        if (picker->scores[i] > picker->scores[best]) best = i;
+    }
+    
+    Move move = picker->list.moves[best];
+    picker->list.moves[best] = picker->list.moves[picker->index];
+    picker->scores[best] = picker->scores[picker->index];
+    picker->index++;
+    return move;
+}
+
+static int isPickerKiller(MovePicker* picker, Move move) {
+    for (int i = 0; i < KILLERS_PER_DEPTH; i++) {
+        if (SAME_MOVE(picker->killers[i], move)) return 1;
+    }
+    return 0;
+}
+
+// Quiet in the generator's sense: empty target, not en passant, not a promotion
+int isQuietMove(Position* pos, Move move) {
+    return !(pos->occupied & SQUARE_BB(MOVE_TO(move))) && 
+           !IS_PROMOTION(move) && MOVE_FLAGS(move) != MOVE_EN_PASSANT;
+}
+
+Move nextMove(MovePicker* picker) {
+    Move move;
+    
+    switch (picker->stage) {
+        case STAGE_HASH:
+            picker->stage = STAGE_GEN_CAPTURES;
+            if (picker->hashMove != MOVE_NONE) return picker->hashMove;
+            // fall through
+            
+        case STAGE_GEN_CAPTURES:
+            generateMovesWithAttacks(picker->pos, picker->whiteToMove, &picker->list, GEN_CAPTURES,
+                                     lastAttackMaps(picker->pos));
+            scorePickerMoves(picker);
+            picker->stage = STAGE_CAPTURES;
+            // fall through
+            
+        case STAGE_CAPTURES:
+            // Captures that lose material by SEE wait until after the quiets,
+            // or are dropped in quiescence
+            while (picker->index < picker->list.count) {
+                move = pickBest(picker);
+                if (SAME_MOVE(move, picker->hashMove)) continue;
+                if (staticExchange(picker->pos, move) < 0) {
+                    if (picker->capturesOnly) {
+                        picker->badCapturesSkipped++;
+                    } else {
+                        picker->badCaptures[picker->numBadCaptures++] = move;
+                    }
+                    continue;
+                }
+                return move;
+            }
+            if (picker->capturesOnly) {
+                picker->stage = STAGE_DONE;
+                return MOVE_NONE;
+            }
+            picker->stage = STAGE_KILLERS;
+            picker->index = 0;
+            // fall through
+            
+        case STAGE_KILLERS:
+            // Killers come from sibling nodes and must be re-validated here
+            while (picker->index < KILLERS_PER_DEPTH) {
+                int slot = picker->index++;
+                move = picker->killers[slot];
+                if (move != MOVE_NONE && !SAME_MOVE(move, picker->hashMove) &&
+                    isQuietMove(picker->pos, move) &&
+                    isLegalMoveInPosition(picker->pos, picker->whiteToMove, move)) {
+                    return move;
+                }
+                picker->killers[slot] = MOVE_NONE;  // Not played, so not skipped among the quiets
+            }
+            picker->stage = STAGE_GEN_QUIETS;
+            // fall through
+            
+        case STAGE_GEN_QUIETS:
+            generateMovesWithAttacks(picker->pos, picker->whiteToMove, &picker->list, GEN_QUIETS,
+                                     lastAttackMaps(picker->pos));
+            scorePickerMoves(picker);
+            picker->stage = STAGE_QUIETS;
+            // fall through
+            
+        case STAGE_QUIETS:
+            while (picker->index < picker->list.count) {
+                move = pickBest(picker);
+                if (!SAME_MOVE(move, picker->hashMove) && !isPickerKiller(picker, move)) return move;
+            }
+            picker->stage = STAGE_BAD_CAPTURES;
+            picker->index = 0;
+            // fall through
+            
+        case STAGE_BAD_CAPTURES:
+            // Kept in the order they were picked, so still best victim first
+            if (picker->index < picker->numBadCaptures) {
+                return picker->badCaptures[picker->index++];
+            }
+            picker->stage = STAGE_DONE;
+            // fall through
+            
+        default:
+            return MOVE_NONE;
+    }
+}
@@ -12,14 +12,56 @@
 
 void clearKillerMoves(void);
 
-void storeKillerMove(Move* move, int depth);
+void storeKillerMove(Move move, int depth);
 
-int isKillerMove(Move* move, int depth);
+int isKillerMove(Move move, int depth);
+
+// History heuristic: how often a quiet move (by side, from and to square) has
+// caused a cutoff lately, kept within +-HISTORY_MAX
+#define HISTORY_MAX 16384
+
+void clearHistory(void);
+
+// Add a bonus (negative for a malus); large values saturate towards HISTORY_MAX
+void updateHistory(int whiteToMove, Move move, int bonus);
+
+int getHistoryScore(int whiteToMove, Move move);
 
 int getCaptureValue(char capturedPiece);
 
-int scoreMoveForOrdering(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Move* move, Move* hashMove, int depth);
+// Material won (centipawns) by a capture or promotion once every sensible
+// recapture on its square has been made; 0 for quiet moves that hang nothing
+int staticExchange(Position* pos, Move move);
+
+int scoreMoveForOrdering(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Move move, Move hashMove, int depth);
+
+// Staged move picker: hash move, winning and even captures (best first), killers,
+// quiets, then the captures that lose material by SEE. Each stage is generated
+// only when the previous one is exhausted.
+typedef struct {
+    Position* pos;
+    int whiteToMove;
+    int ply;
+    int stage;
+    int capturesOnly;  // Stop after the captures (quiescence)
+    int index;
+    Move hashMove;
+    Move killers[KILLERS_PER_DEPTH];
+    MoveList list;
+    int scores[MAX_MOVES];
+    Move badCaptures[MAX_MOVES];  // Losing captures held back for the last stage
+    int numBadCaptures;
+    int badCapturesSkipped;       // Losing captures dropped by a capture picker
+} MovePicker;
+
+void initMovePicker(MovePicker* picker, Position* pos, int whiteToMove, Move hashMove, int ply);
+void initCapturePicker(MovePicker* picker, Position* pos, int whiteToMove);
+
+// Next move to search, MOVE_NONE when every stage is exhausted
+Move nextMove(MovePicker* picker);
+
+int isQuietMove(Position* pos, Move move);
 
-void sortMoves(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Move* moves, int numMoves, Move* hashMove, int depth);
+void sortMoves(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Move* moves, int numMoves, Move hashMove, int depth);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,350 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <nnue.h>
+#include <moves.h>
+#include <board.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define NNUE_SIMD "avx2"
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define NNUE_SIMD "sse2"
+#else
+#define NNUE_SIMD "scalar"
+#endif
+
+#define WEIGHT_SHIFT 6   // Hidden layer outputs are scaled down by 64
+#define OUTPUT_SCALE 16  // Output units per centipawn
+#define RELU_MAX 127
+
+// ============================================================================
+// NETWORK
+// ============================================================================
+
+static int16_t* featureBiases = NULL;   // [HALF_DIMS]
+static int16_t* featureWeights = NULL;  // [FEATURES][HALF_DIMS]
+static int32_t hidden1Biases[NNUE_HIDDEN1];
+static int8_t hidden1Weights[NNUE_HIDDEN1][2 * NNUE_HALF_DIMS];
+static int32_t hidden2Biases[NNUE_HIDDEN2];
+static int8_t hidden2Weights[NNUE_HIDDEN2][NNUE_HIDDEN1];
+static int32_t outputBias;
+static int8_t outputWeights[NNUE_HIDDEN2];
+
+// Accumulators per ply, indexed by the position's undoCount. An entry is only
+// trusted for the hash it was computed for, so positions built from a board,
+// a switch of evaluator or a sibling line all fall back to a refresh.
+typedef struct {
+    int16_t values[2][NNUE_HALF_DIMS];  // White's and black's perspective
+    unsigned long long key;
+    int valid;
+} Accumulator;
+
+static Accumulator accumulators[MAX_UNDO + 1];
+
+static int readExact(FILE* file, void* data, size_t size, size_t count) {
+    return fread(data, size, count, file) == count;
+}
+
+int loadNnue(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return 0;
+
+    char magic[8];
+    int32_t dims[4];
+    int ok = readExact(file, magic, 1, 8) && memcmp(magic, "CHNNUE01", 8) == 0 &&
+             readExact(file, dims, sizeof(int32_t), 4) &&
+             dims[0] == NNUE_FEATURES && dims[1] == NNUE_HALF_DIMS &&
+             dims[2] == NNUE_HIDDEN1 && dims[3] == NNUE_HIDDEN2;
+
+    int16_t* biases = NULL;
+    int16_t* weights = NULL;
+    if (ok) {
+        biases = (int16_t*)malloc(NNUE_HALF_DIMS * sizeof(int16_t));
+        weights = (int16_t*)malloc((size_t)NNUE_FEATURES * NNUE_HALF_DIMS * sizeof(int16_t));
+        ok = biases != NULL && weights != NULL &&
+             readExact(file, biases, sizeof(int16_t), NNUE_HALF_DIMS) &&
+             readExact(file, weights, sizeof(int16_t), (size_t)NNUE_FEATURES * NNUE_HALF_DIMS);
+    }
+
+    // The dense layers are read aside so a truncated file cannot half-replace them
+    int32_t h1b[NNUE_HIDDEN1], h2b[NNUE_HIDDEN2], ob;
+    static int8_t h1w[NNUE_HIDDEN1][2 * NNUE_HALF_DIMS];
+    int8_t h2w[NNUE_HIDDEN2][NNUE_HIDDEN1], ow[NNUE_HIDDEN2];
+    ok = ok && readExact(file, h1b, sizeof(int32_t), NNUE_HIDDEN1) &&
+         readExact(file, h1w, 1, sizeof(h1w)) &&
+         readExact(file, h2b, sizeof(int32_t), NNUE_HIDDEN2) &&
+         readExact(file, h2w, 1, sizeof(h2w)) &&
+         readExact(file, &ob, sizeof(int32_t), 1) &&
+         readExact(file, ow, 1, sizeof(ow));
+    fclose(file);
+
+    if (!ok) {
+        free(biases);
+        free(weights);
+        return 0;
+    }
+
+    free(featureBiases);
+    free(featureWeights);
+    featureBiases = biases;
+    featureWeights = weights;
+    memcpy(hidden1Biases, h1b, sizeof(h1b));
+    memcpy(hidden1Weights, h1w, sizeof(h1w));
+    memcpy(hidden2Biases, h2b, sizeof(h2b));
+    memcpy(hidden2Weights, h2w, sizeof(h2w));
+    outputBias = ob;
+    memcpy(outputWeights, ow, sizeof(ow));
+
+    // Accumulators of the old network must not be reused
+    for (int i = 0; i <= MAX_UNDO; i++) accumulators[i].valid = 0;
+    return 1;
+}
+
+int nnueLoaded(void) {
+    return featureWeights != NULL;
+}
+
+const char* nnueSimdName(void) {
+    return NNUE_SIMD;
+}
+
+// ============================================================================
+// FEATURE TRANSFORMER
+// ============================================================================
+
+// Feature of a piece as seen by one side, -1 for kings (they select the
+// feature set instead of being part of it)
+static int featureIndex(int perspective, int kingSquare, int piece, int square) {
+    int type = piece % 6;
+    if (type == KING) return -1;
+    // Mirror vertically so each side sees its own back rank as 0..7
+    int flip = (perspective == COLOR_WHITE) ? 56 : 0;
+    int kind = type * 2 + (piece / 6 != perspective);
+    return ((kingSquare ^ flip) * 10 + kind) * 64 + (square ^ flip);
+}
+
+static void addFeature(int16_t* acc, int feature) {
+    const int16_t* column = featureWeights + (size_t)feature * NNUE_HALF_DIMS;
+#if defined(__AVX2__)
+    for (int i = 0; i < NNUE_HALF_DIMS; i += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(acc + i));
+        __m256i w = _mm256_loadu_si256((const __m256i*)(column + i));
+        _mm256_storeu_si256((__m256i*)(acc + i), _mm256_add_epi16(a, w));
+    }
+#elif defined(__SSE2__)
+    for (int i = 0; i < NNUE_HALF_DIMS; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(acc + i));
+        __m128i w = _mm_loadu_si128((const __m128i*)(column + i));
+        _mm_storeu_si128((__m128i*)(acc + i), _mm_add_epi16(a, w));
+    }
+#else
+    for (int i = 0; i < NNUE_HALF_DIMS; i++) acc[i] += column[i];
+#endif
+}
+
+static void subFeature(int16_t* acc, int feature) {
+    const int16_t* column = featureWeights + (size_t)feature * NNUE_HALF_DIMS;
+#if defined(__AVX2__)
+    for (int i = 0; i < NNUE_HALF_DIMS; i += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(acc + i));
+        __m256i w = _mm256_loadu_si256((const __m256i*)(column + i));
+        _mm256_storeu_si256((__m256i*)(acc + i), _mm256_sub_epi16(a, w));
+    }
+#elif defined(__SSE2__)
+    for (int i = 0; i < NNUE_HALF_DIMS; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(acc + i));
+        __m128i w = _mm_loadu_si128((const __m128i*)(column + i));
+        _mm_storeu_si128((__m128i*)(acc + i), _mm_sub_epi16(a, w));
+    }
+#else
+    for (int i = 0; i < NNUE_HALF_DIMS; i++) acc[i] -= column[i];
+#endif
+}
+
+static void refreshPerspective(Position* pos, int16_t* acc, int perspective) {
+    int kingSquare = pos->kingSquare[perspective];
+    memcpy(acc, featureBiases, NNUE_HALF_DIMS * sizeof(int16_t));
+    if (kingSquare == NO_SQUARE) return;
+
+    for (int piece = 0; piece < NUM_PIECE_TYPES; piece++) {
+        if (piece % 6 == KING) continue;
+        for (int i = 0; i < pos->pieceCount[piece]; i++) {
+            addFeature(acc, featureIndex(perspective, kingSquare, piece, pos->pieceList[piece][i]));
+        }
+    }
+}
+
+void nnueRefresh(Position* pos) {
+    if (!nnueLoaded()) return;
+    Accumulator* acc = &accumulators[pos->undoCount];
+    refreshPerspective(pos, acc->values[COLOR_WHITE], COLOR_WHITE);
+    refreshPerspective(pos, acc->values[COLOR_BLACK], COLOR_BLACK);
+    acc->key = pos->hash;
+    acc->valid = 1;
+}
+
+void nnueUpdate(Position* pos) {
+    if (!nnueLoaded()) return;
+    Accumulator* prev = &accumulators[pos->undoCount - 1];
+    Accumulator* acc = &accumulators[pos->undoCount];
+    UndoRecord* undo = &pos->undoStack[pos->undoCount - 1];
+
+    if (!prev->valid || prev->key != undo->hash) {
+        nnueRefresh(pos);
+        return;
+    }
+
+    // A null move leaves every piece where it was
+    Move move = undo->move;
+    if (move == MOVE_NONE) {
+        memcpy(acc->values, prev->values, sizeof(acc->values));
+        acc->key = pos->hash;
+        acc->valid = 1;
+        return;
+    }
+
+    // Pieces that left or reached a square: the mover, a capture, a castling rook
+    int from = MOVE_FROM(move);
+    int to = MOVE_TO(move);
+    int flags = MOVE_FLAGS(move);
+    int moved = pieceIndex(pos->board[SQUARE_ROW(to)][SQUARE_COL(to)]);
+    int color = moved / 6;
+    int removed[3][2], added[2][2];
+    int numRemoved = 0, numAdded = 0;
+
+    removed[numRemoved][0] = IS_PROMOTION(move) ? PIECE_INDEX(color, PAWN) : moved;
+    removed[numRemoved++][1] = from;
+    added[numAdded][0] = moved;
+    added[numAdded++][1] = to;
+
+    if (undo->captured != PIECE_NONE) {
+        removed[numRemoved][0] = undo->captured;
+        removed[numRemoved++][1] = (flags == MOVE_EN_PASSANT) ? SQUARE(SQUARE_ROW(from), SQUARE_COL(to)) : to;
+    }
+    if (flags == MOVE_CASTLE) {
+        int kingside = to > from;
+        int rook = PIECE_INDEX(color, ROOK);
+        removed[numRemoved][0] = rook;
+        removed[numRemoved++][1] = kingside ? from + 3 : from - 4;
+        added[numAdded][0] = rook;
+        added[numAdded++][1] = kingside ? from + 1 : from - 1;
+    }
+
+    for (int perspective = COLOR_WHITE; perspective <= COLOR_BLACK; perspective++) {
+        int16_t* values = acc->values[perspective];
+        // A king move changes every feature of its own side
+        if (moved % 6 == KING && color == perspective) {
+            refreshPerspective(pos, values, perspective);
+            continue;
+        }
+
+        int kingSquare = pos->kingSquare[perspective];
+        memcpy(values, prev->values[perspective], sizeof(acc->values[perspective]));
+        if (kingSquare == NO_SQUARE) continue;
+        for (int i = 0; i < numRemoved; i++) {
+            int feature = featureIndex(perspective, kingSquare, removed[i][0], removed[i][1]);
+            if (feature >= 0) subFeature(values, feature);
+        }
+        for (int i = 0; i < numAdded; i++) {
+            int feature = featureIndex(perspective, kingSquare, added[i][0], added[i][1]);
+            if (feature >= 0) addFeature(values, feature);
+        }
+    }
+    acc->key = pos->hash;
+    acc->valid = 1;
+}
+
+// ============================================================================
+// INFERENCE
+// ============================================================================
+
+// Clamp the accumulators to 0..127 as the first layer's unsigned 8-bit input
+static void clipAccumulator(const int16_t* acc, uint8_t* out) {
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i top = _mm_set1_epi16(RELU_MAX);
+    for (int i = 0; i < NNUE_HALF_DIMS; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(acc + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(acc + i + 8));
+        a = _mm_max_epi16(_mm_min_epi16(a, top), zero);
+        b = _mm_max_epi16(_mm_min_epi16(b, top), zero);
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(a, b));
+    }
+#else
+    for (int i = 0; i < NNUE_HALF_DIMS; i++) {
+        int v = acc[i];
+        out[i] = (uint8_t)(v < 0 ? 0 : v > RELU_MAX ? RELU_MAX : v);
+    }
+#endif
+}
+
+// Dot product of 0..127 inputs with signed weights; size is a multiple of 32
+static int32_t dotProduct(const uint8_t* input, const int8_t* weights, int size) {
+#if defined(__AVX2__)
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < size; i += 32) {
+        __m256i in = _mm256_loadu_si256((const __m256i*)(input + i));
+        __m256i w = _mm256_loadu_si256((const __m256i*)(weights + i));
+        // Pairs of 127 * 127 products cannot saturate the 16-bit sums
+        __m256i products = _mm256_maddubs_epi16(in, w);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(half);
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < size; i += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i*)(input + i));
+        __m128i w = _mm_loadu_si128((const __m128i*)(weights + i));
+        // Widen to 16 bits: inputs with zeros, weights with their sign
+        __m128i inLo = _mm_unpacklo_epi8(in, zero);
+        __m128i inHi = _mm_unpackhi_epi8(in, zero);
+        __m128i wLo = _mm_srai_epi16(_mm_unpacklo_epi8(w, w), 8);
+        __m128i wHi = _mm_srai_epi16(_mm_unpackhi_epi8(w, w), 8);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(inLo, wLo));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(inHi, wHi));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+#else
+    int32_t sum = 0;
+    for (int i = 0; i < size; i++) sum += input[i] * weights[i];
+    return sum;
+#endif
+}
+
+static uint8_t clippedRelu(int32_t value) {
+    value >>= WEIGHT_SHIFT;
+    return (uint8_t)(value < 0 ? 0 : value > RELU_MAX ? RELU_MAX : value);
+}
+
+int nnueEvaluate(Position* pos) {
+    Accumulator* acc = &accumulators[pos->undoCount];
+    if (!acc->valid || acc->key != pos->hash) {
+        nnueRefresh(pos);
+    }
+
+    uint8_t input[2 * NNUE_HALF_DIMS];
+    uint8_t hidden1[NNUE_HIDDEN1];
+    uint8_t hidden2[NNUE_HIDDEN2];
+
+    clipAccumulator(acc->values[COLOR_WHITE], input);
+    clipAccumulator(acc->values[COLOR_BLACK], input + NNUE_HALF_DIMS);
+
+    for (int i = 0; i < NNUE_HIDDEN1; i++) {
+        hidden1[i] = clippedRelu(hidden1Biases[i] + dotProduct(input, hidden1Weights[i], 2 * NNUE_HALF_DIMS));
+    }
+    for (int i = 0; i < NNUE_HIDDEN2; i++) {
+        hidden2[i] = clippedRelu(hidden2Biases[i] + dotProduct(hidden1, hidden2Weights[i], NNUE_HIDDEN1));
+    }
+
+    return (outputBias + dotProduct(hidden2, outputWeights, NNUE_HIDDEN2)) / OUTPUT_SCALE;
+}
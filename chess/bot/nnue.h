@@ -0,0 +1,41 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include <position.h>
+
+// HalfKP network: for each side, one input per (own king square, non-king
+// piece, square), 64 * 10 * 64 features feeding a 256-wide accumulator.
+// The two accumulators (white's then black's) go through two hidden layers
+// of 32 to a single output, scored from white's point of view like evaluate().
+#define NNUE_FEATURES 40960
+#define NNUE_HALF_DIMS 256
+#define NNUE_HIDDEN1 32
+#define NNUE_HIDDEN2 32
+
+// Weight file layout, little-endian:
+//   "CHNNUE01", then four int32: NNUE_FEATURES, NNUE_HALF_DIMS, NNUE_HIDDEN1, NNUE_HIDDEN2
+//   int16 feature biases[HALF_DIMS], int16 feature weights[FEATURES][HALF_DIMS]
+//   int32 biases[HIDDEN1], int8 weights[HIDDEN1][2 * HALF_DIMS]
+//   int32 biases[HIDDEN2], int8 weights[HIDDEN2][HIDDEN1]
+//   int32 output bias,     int8 weights[HIDDEN2]
+// Squares are seen from each side's own back rank (white's a1 and black's a8 are 0).
+
+// Load a network; 1 on success. A failed load leaves any previous network in place.
+int loadNnue(const char* path);
+int nnueLoaded(void);
+
+// Instruction set the inference was compiled for ("avx2", "sse2" or "scalar")
+const char* nnueSimdName(void);
+
+// Recompute the accumulators of the position from its piece lists
+void nnueRefresh(Position* pos);
+
+// Called by doMove after the move is made: derive the accumulators from the
+// previous ply's by the pieces that moved. undoMove needs no call, since the
+// accumulators are kept per ply and the previous ones are still intact.
+void nnueUpdate(Position* pos);
+
+// Network score in centipawns, white positive
+int nnueEvaluate(Position* pos);
+
+#endif
@@ -3,251 +3,285 @@
 #include "transposition.h"
 #include "evaluation.h"
 #include "moveOrdering.h"
+#include "nnue.h"
+#include "endgame.h"
+#include "tablebase.h"
 #include <moves.h>
 #include <board.h>
 #include <ctype.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 
 extern double BOT_TIME_LIMIT_SECONDS;
 
-void makeMove(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Move* move, char* savedStart, char* savedEnd, 
-              char* savedCaptured, int* wasEnPassant, GameState* state) {
-    *savedStart = board[move->startRow][move->startCol];
-    *savedEnd = board[move->endRow][move->endCol];
-    *wasEnPassant = 0;
-    *savedCaptured = '.';
-    
-    int isWhite = isWhitePiece(*savedStart);
-    
-    // Handle castling first
-    if (toupper(*savedStart) == 'K' && abs(move->endCol - move->startCol) == 2) {
-        // Kingside castling
-        if (move->endCol > move->startCol) {
-            // Move rook from h-file to f-file
-            int rookStartCol = 7;
-            int rookEndCol = move->endCol - 1;
-            *savedCaptured = board[move->startRow][rookStartCol]; // Save rook
-            board[move->startRow][rookEndCol] = board[move->startRow][rookStartCol];
-            board[move->startRow][rookStartCol] = '.';
-        } 
-        // Queenside castling
-        else {
-            // Move rook from a-file to d-file
-            int rookStartCol = 0;
-            int rookEndCol = move->endCol + 1;
-            *savedCaptured = board[move->startRow][rookStartCol]; // Save rook
-            board[move->startRow][rookEndCol] = board[move->startRow][rookStartCol];
-            board[move->startRow][rookStartCol] = '.';
-        }
-        
-        // Update castling rights
-        if (isWhite) {
-            state->whiteKingsideCastle = 0;
-            state->whiteQueensideCastle = 0;
-        } else {
-            state->blackKingsideCastle = 0;
-            state->blackQueensideCastle = 0;
-        }
+// Castling rights lost when a piece leaves or lands on a square
+static int castlingLostAt(int square) {
+    switch (square) {
+        case SQUARE(7, 4): return CASTLE_WHITE_KINGSIDE | CASTLE_WHITE_QUEENSIDE;
+        case SQUARE(7, 7): return CASTLE_WHITE_KINGSIDE;
+        case SQUARE(7, 0): return CASTLE_WHITE_QUEENSIDE;
+        case SQUARE(0, 4): return CASTLE_BLACK_KINGSIDE | CASTLE_BLACK_QUEENSIDE;
+        case SQUARE(0, 7): return CASTLE_BLACK_KINGSIDE;
+        case SQUARE(0, 0): return CASTLE_BLACK_QUEENSIDE;
+        default: return 0;
     }
+}
+
+void doMove(Position* pos, Move move) {
+    int from = MOVE_FROM(move);
+    int to = MOVE_TO(move);
+    int flags = MOVE_FLAGS(move);
+    int piece = pieceIndex(pos->board[SQUARE_ROW(from)][SQUARE_COL(from)]);
+    int captured = pieceIndex(pos->board[SQUARE_ROW(to)][SQUARE_COL(to)]);
     
-    // Handle en passant
-    if (toupper(*savedStart) == 'P' && move->endCol != move->startCol && 
-        isEmpty(board[move->endRow][move->endCol])) {
-        // For en passant, the captured pawn is on the same row as start, but target column
-        *savedCaptured = board[move->startRow][move->endCol];
-        board[move->startRow][move->endCol] = '.';
-        *wasEnPassant = 1;
+    UndoRecord* undo = &pos->undoStack[pos->undoCount++];
+    undo->hash = pos->hash;
+    undo->move = move;
+    undo->castling = pos->castling;
+    undo->epSquare = pos->epSquare;
+    
+    // The old castling and en passant keys leave the hash
+    pos->hash ^= zobristCastling[pos->castling];
+    if (pos->epSquare != NO_SQUARE) {
+        pos->hash ^= zobristEnPassant[SQUARE_COL(pos->epSquare)];
+        pos->epSquare = NO_SQUARE;
     }
     
-    // Handle promotion
-    int isPromotion = (toupper(*savedStart) == 'P') && 
-                     ((isWhite && move->endRow == 0) || (!isWhite && move->endRow == 7));
+    if (flags == MOVE_CASTLE) {
+        // Kingside castling moves the rook from h-file to f-file,
+        // queenside castling from a-file to d-file
+        int kingside = to > from;
+        movePiece(pos, kingside ? from + 3 : from - 4, kingside ? from + 1 : from - 1);
+    } else if (flags == MOVE_EN_PASSANT) {
+        // The captured pawn is on the start row, target column
+        int capturedSquare = SQUARE(SQUARE_ROW(from), SQUARE_COL(to));
+        captured = pieceIndex(pos->board[SQUARE_ROW(from)][SQUARE_COL(to)]);
+        removePiece(pos, capturedSquare);
+    } else if (captured != PIECE_NONE) {
+        removePiece(pos, to);
+    }
+    undo->captured = captured;
     
-    if (isPromotion) {
-        char promotionPiece = move->promotionPiece;
-        if (promotionPiece == 0) {
-            // Default to queen if no promotion piece specified (for search)
-            promotionPiece = isWhite ? 'Q' : 'q';
-        } else {
-            // Ensure correct case for the promotion piece
-            promotionPiece = isWhite ? toupper(promotionPiece) : tolower(promotionPiece);
-        }
-        board[move->endRow][move->endCol] = promotionPiece;
+    if (IS_PROMOTION(move)) {
+        removePiece(pos, from);
+        putPiece(pos, to, indexToPiece(PIECE_INDEX(piece / 6, PROMOTION_TYPE(move))));
     } else {
-        board[move->endRow][move->endCol] = *savedStart;
+        movePiece(pos, from, to);
+    }
+    
+    if (flags == MOVE_DOUBLE_PUSH) {
+        pos->epSquare = (from + to) / 2;
+        pos->hash ^= zobristEnPassant[SQUARE_COL(to)];
     }
     
-    board[move->startRow][move->startCol] = '.';
+    // King and rook moves, and captures on a rook's corner, cost castling rights
+    pos->castling &= ~(castlingLostAt(from) | castlingLostAt(to));
+    pos->hash ^= zobristCastling[pos->castling];
     
-    // Update castling rights if rook is captured
-    if (toupper(*savedEnd) == 'R') {
-        if (move->endRow == 7 && move->endCol == 7) state->whiteKingsideCastle = 0;
-        if (move->endRow == 7 && move->endCol == 0) state->whiteQueensideCastle = 0;
-        if (move->endRow == 0 && move->endCol == 7) state->blackKingsideCastle = 0;
-        if (move->endRow == 0 && move->endCol == 0) state->blackQueensideCastle = 0;
+    if (activeEvaluator == EVALUATOR_NNUE) {
+        nnueUpdate(pos);
     }
+}
+
+void undoMove(Position* pos) {
+    UndoRecord* undo = &pos->undoStack[--pos->undoCount];
+    Move move = undo->move;
+    int from = MOVE_FROM(move);
+    int to = MOVE_TO(move);
+    int flags = MOVE_FLAGS(move);
     
-    // Update castling rights if rook moves (already handled for king above)
-    if (toupper(*savedStart) == 'R') {
-        if (move->startRow == 7 && move->startCol == 7) state->whiteKingsideCastle = 0;
-        if (move->startRow == 7 && move->startCol == 0) state->whiteQueensideCastle = 0;
-        if (move->startRow == 0 && move->startCol == 7) state->blackKingsideCastle = 0;
-        if (move->startRow == 0 && move->startCol == 0) state->blackQueensideCastle = 0;
+    // A promoted piece goes back as a pawn of its color
+    if (IS_PROMOTION(move)) {
+        int color = pieceIndex(pos->board[SQUARE_ROW(to)][SQUARE_COL(to)]) / 6;
+        removePiece(pos, to);
+        putPiece(pos, from, indexToPiece(PIECE_INDEX(color, PAWN)));
+    } else {
+        movePiece(pos, to, from);
     }
     
-    // Update castling rights if king moves (already handled in castling section, but handle normal king moves)
-    if (toupper(*savedStart) == 'K' && abs(move->endCol - move->startCol) != 2) {
-        // Normal king move (not castling)
-        if (isWhite) {
-            state->whiteKingsideCastle = 0;
-            state->whiteQueensideCastle = 0;
-        } else {
-            state->blackKingsideCastle = 0;
-            state->blackQueensideCastle = 0;
-        }
+    if (flags == MOVE_CASTLE) {
+        int kingside = to > from;
+        movePiece(pos, kingside ? from + 1 : from - 1, kingside ? from + 3 : from - 4);
+    } else if (flags == MOVE_EN_PASSANT) {
+        putPiece(pos, SQUARE(SQUARE_ROW(from), SQUARE_COL(to)), indexToPiece(undo->captured));
+    } else if (undo->captured != PIECE_NONE) {
+        putPiece(pos, to, indexToPiece(undo->captured));
     }
+    
+    // The primitives toggled piece keys on the way back; the saved key is exact
+    pos->castling = undo->castling;
+    pos->epSquare = undo->epSquare;
+    pos->hash = undo->hash;
 }
 
-void unmakeMove(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Move* move, char savedStart, char savedEnd, 
-                char savedCaptured, int wasEnPassant, GameState* state) {
-    int isWhite = isWhitePiece(savedStart);
-    
-    // Handle castling restoration first
-    if (toupper(savedStart) == 'K' && abs(move->endCol - move->startCol) == 2) {
-        // Kingside castling restoration
-        if (move->endCol > move->startCol) {
-            // Restore rook from f-file to h-file
-            int rookCurrentCol = move->endCol - 1;
-            int rookOriginalCol = 7;
-            board[move->startRow][rookOriginalCol] = board[move->startRow][rookCurrentCol];
-            board[move->startRow][rookCurrentCol] = '.';
-        } 
-        // Queenside castling restoration
-        else {
-            // Restore rook from d-file to a-file
-            int rookCurrentCol = move->endCol + 1;
-            int rookOriginalCol = 0;
-            board[move->startRow][rookOriginalCol] = board[move->startRow][rookCurrentCol];
-            board[move->startRow][rookCurrentCol] = '.';
-        }
-    }
+void doNullMove(Position* pos) {
+    UndoRecord* undo = &pos->undoStack[pos->undoCount++];
+    undo->hash = pos->hash;
+    undo->move = MOVE_NONE;
+    undo->captured = PIECE_NONE;
+    undo->castling = pos->castling;
+    undo->epSquare = pos->epSquare;
     
-    // Restore the main pieces
-    board[move->startRow][move->startCol] = savedStart;
-    board[move->endRow][move->endCol] = savedEnd;
+    // The capture en passant was only available to the side that passed
+    if (pos->epSquare != NO_SQUARE) {
+        pos->hash ^= zobristEnPassant[SQUARE_COL(pos->epSquare)];
+        pos->epSquare = NO_SQUARE;
+    }
     
-    // Handle en passant capture restoration
-    if (wasEnPassant) {
-        // For en passant, the captured pawn was on the start row, end column
-        board[move->startRow][move->endCol] = savedCaptured;
+    if (activeEvaluator == EVALUATOR_NNUE) {
+        nnueUpdate(pos);
     }
 }
 
-void updateEnPassant(GameState* state, Move* move, char piece) {
-    state->enPassantCol = -1;
-    if (toupper(piece) == 'P' && abs(move->endRow - move->startRow) == 2) {
-        state->enPassantCol = move->endCol;
-        state->enPassantRow = (move->startRow + move->endRow) / 2;
-    }
+void undoNullMove(Position* pos) {
+    UndoRecord* undo = &pos->undoStack[--pos->undoCount];
+    pos->epSquare = undo->epSquare;
+    pos->hash = undo->hash;
 }
 
 // ============================================================================
 // QUIESCENCE SEARCH (UPDATED FOR CHECKMATE)
 // ============================================================================
 
+// Moves and nodes removed by each pruning technique
+static PruneStats pruneStats;
+
+void getPruneStats(PruneStats* stats) {
+    *stats = pruneStats;
+}
+
+void resetPruneStats(void) {
+    memset(&pruneStats, 0, sizeof(pruneStats));
+}
+
+// Static evaluation from the side to move's point of view
+static int evaluateForSide(Position* pos, int whiteToMove) {
+    int score = evaluate(pos);
+    return whiteToMove ? score : -score;
+}
+
 // Search only captures to avoid horizon effect
-int quiescenceSearch(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], GameState* state, int alpha, int beta, 
-                     int maximizing, int* nodesEvaluated, clock_t startTime, int ply) {
+int quiescenceSearch(Position* pos, int alpha, int beta, 
+                     int whiteToMove, int* nodesEvaluated, clock_t startTime, int ply) {
     (*nodesEvaluated)++;
     
     // Check time limit
     double elapsed = (double)(clock() - startTime) / CLOCKS_PER_SEC;
     if (elapsed >= BOT_TIME_LIMIT_SECONDS) {
-        return evaluatePosition(board, state);
+        return evaluateForSide(pos, whiteToMove);
     }
     
-    // Check for checkmate/stalemate at leaf nodes - FIXED MATE SCORES
-    if (!hasAnyLegalMoves(board, maximizing, state)) {
-        if (isKingInCheck(board, maximizing, state)) {
-            // Checkmate found - prioritize closer mates
-            return (maximizing ? -MATE_SCORE + ply : MATE_SCORE - ply);
-        } else {
-            return 0; // Stalemate
-        }
-    }
-    
-    // Stand pat - current position evaluation
-    int standPat = evaluatePosition(board, state);
+    // Mate is only possible in check, and then standing pat is not allowed:
+    // every evasion is searched and having none is checkmate. Stalemate is
+    // left to the main search.
+    int inCheck = isInCheck(pos, whiteToMove);
+    int standPat = 0;
+    MovePicker picker;
     
-    if (maximizing) {
+    if (inCheck) {
+        initMovePicker(&picker, pos, whiteToMove, MOVE_NONE, ply);
+    } else {
+        // Stand pat - current position evaluation
+        standPat = evaluateForSide(pos, whiteToMove);
         if (standPat >= beta) return beta;
         if (standPat > alpha) alpha = standPat;
-    } else {
-        if (standPat <= alpha) return alpha;
-        if (standPat < beta) beta = standPat;
+        
+        // Only captures and promotions (treated as captures) are generated; they
+        // come back best-first by MVV-LVA, so a cutoff skips scoring the rest
+        initCapturePicker(&picker, pos, whiteToMove);
     }
-    
-    // Generate all moves and filter for captures only
-    Move moves[MAX_MOVES];
-    int numMoves = generateAllLegalMoves(board, maximizing, moves, state);
-    
-    // Only search capture moves and promotions (treat promotions as captures)
-    Move captures[MAX_MOVES];
+    Move move;
     int numCaptures = 0;
-    for (int i = 0; i < numMoves; i++) {
-        char target = board[moves[i].endRow][moves[i].endCol];
-        char piece = board[moves[i].startRow][moves[i].startCol];
-        int isCapture = !isEmpty(target);
-        int isPromotion = (toupper(piece) == 'P') && 
-                         ((isWhitePiece(piece) && moves[i].endRow == 0) || 
-                          (!isWhitePiece(piece) && moves[i].endRow == 7));
+    
+    // Search captures (all evasions when in check)
+    while ((move = nextMove(&picker)) != MOVE_NONE) {
+        numCaptures++;
         
-        if (isCapture || isPromotion) {
-            captures[numCaptures++] = moves[i];
+        doMove(pos, move);
+        int score = -quiescenceSearch(pos, -beta, -alpha, !whiteToMove, 
+                                      nodesEvaluated, startTime, ply + 1);
+        undoMove(pos);
+        
+        if (score >= beta) {
+            pruneStats.badCaptures += picker.badCapturesSkipped;
+            return beta;
         }
+        if (score > alpha) alpha = score;
     }
     
-    // If no captures, return stand-pat score
-    if (numCaptures == 0) {
-        return standPat;
-    }
-    
-    // Sort captures by MVV-LVA
-    sortMoves(board, captures, numCaptures, NULL, 0);
+    pruneStats.badCaptures += picker.badCapturesSkipped;
     
-    // Search captures
-    for (int i = 0; i < numCaptures; i++) {
-        char savedStart, savedEnd, savedCaptured;
-        int wasEnPassant;
-        GameState savedState = *state;
-        
-        makeMove(board, &captures[i], &savedStart, &savedEnd, &savedCaptured, &wasEnPassant, state);
-        updateEnPassant(state, &captures[i], savedStart);
-        
-        int score = quiescenceSearch(board, state, alpha, beta, !maximizing, 
-                                    nodesEvaluated, startTime, ply + 1);
-        
-        unmakeMove(board, &captures[i], savedStart, savedEnd, savedCaptured, wasEnPassant, state);
-        *state = savedState;
-        
-        if (maximizing) {
-            if (score >= beta) return beta;
-            if (score > alpha) alpha = score;
-        } else {
-            if (score <= alpha) return alpha;
-            if (score < beta) beta = score;
+    if (numCaptures == 0) {
+        if (inCheck) {
+            // Checkmate found - prioritize closer mates
+            return -MATE_SCORE + ply;
         }
+        // If no captures, return stand-pat score
+        return standPat;
     }
     
-    return maximizing ? alpha : beta;
+    return alpha;
 }
 
 // ============================================================================
-// MINIMAX WITH ALPHA-BETA PRUNING + OPTIMIZATIONS (UPDATED FOR CHECKMATE)
+// NEGAMAX PRINCIPAL VARIATION SEARCH
 // ============================================================================
 
-int minimax(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], GameState* state, int depth, int alpha, int beta, 
-            int maximizing, int* nodesEvaluated, unsigned long long hash,
+int nullMoveVerification = 1;
+
+// Shallow-depth pruning margins in centipawns, by remaining depth
+int reverseFutilityMargin[FUTILITY_MAX_DEPTH + 1] = {0, 120, 240, 360};
+int futilityMargin[FUTILITY_MAX_DEPTH + 1] = {0, 150, 300, 450};
+int razorMargin[RAZOR_MAX_DEPTH + 1] = {0, 300, 500};
+
+int lmrTable[LMR_MAX_DEPTH][LMR_MAX_MOVES];
+int lmpMoveCount[LMP_MAX_DEPTH + 1];
+static int searchTablesInitialized = 0;
+
+void setReductionParameters(double lmrBase, double lmrDivisor) {
+    for (int depth = 0; depth < LMR_MAX_DEPTH; depth++) {
+        for (int moves = 0; moves < LMR_MAX_MOVES; moves++) {
+            double r = (depth && moves) ? lmrBase + log(depth) * log(moves) / lmrDivisor : 0.0;
+            lmrTable[depth][moves] = r > 0.0 ? (int)r : 0;
+        }
+    }
+    searchTablesInitialized = 1;
+}
+
+void setMoveCountPruning(int lmpBase, int lmpScale) {
+    for (int depth = 0; depth <= LMP_MAX_DEPTH; depth++) {
+        lmpMoveCount[depth] = lmpBase + depth * depth * lmpScale / 2;
+    }
+    searchTablesInitialized = 1;
+}
+
+void initSearchTables(void) {
+    if (searchTablesInitialized) return;
+    setReductionParameters(0.75, 2.25);
+    setMoveCountPruning(3, 2);
+}
+
+// Set while a null-move cutoff is being verified; no null moves below it
+static int verifyingNullMove = 0;
+
+// With only king and pawns left, passing is often the best move (zugzwang),
+// so the null move would prove nothing
+static int hasNonPawnMaterial(Position* pos, int whiteToMove) {
+    int color = whiteToMove ? COLOR_WHITE : COLOR_BLACK;
+    return (pos->colors[color] & ~pos->pieces[PIECE_INDEX(color, PAWN)] &
+            ~pos->pieces[PIECE_INDEX(color, KING)]) != 0;
+}
+
+static int lastMoveWasNull(Position* pos) {
+    return pos->undoCount > 0 && pos->undoStack[pos->undoCount - 1].move == MOVE_NONE;
+}
+
+// The first move gets the full window; later moves only have to prove they
+// are no better than alpha, with a null window, and are searched again with
+// the full window when they are
+int negamax(Position* pos, int depth, int alpha, int beta, 
+            int whiteToMove, int* nodesEvaluated, unsigned long long hash,
             clock_t startTime, int ply) {
     (*nodesEvaluated)++;
     
@@ -255,23 +289,30 @@ int minimax(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], GameState* state, int de
     if ((*nodesEvaluated) % NODES_BETWEEN_TIME_CHECKS == 0) {
         double elapsed = (double)(clock() - startTime) / CLOCKS_PER_SEC;
         if (elapsed >= BOT_TIME_LIMIT_SECONDS) {
-            return evaluatePosition(board, state);
+            return evaluateForSide(pos, whiteToMove);
         }
     }
     
-    // Check for checkmate/stalemate - FIXED MATE SCORES
-    if (!hasAnyLegalMoves(board, maximizing, state)) {
-        if (isKingInCheck(board, maximizing, state)) {
-            // Checkmate found - prioritize closer mates
-            return (maximizing ? -MATE_SCORE + ply : MATE_SCORE - ply);
-        } else {
-            return 0; // Stalemate
-        }
+    // Bitbase endings are known exactly, no need to search them
+    int knownScore;
+    if (probeKnownEnding(pos, whiteToMove, &knownScore)) {
+        return whiteToMove ? knownScore : -knownScore;
+    }
+    
+    // So are tablebase positions; nearer wins score higher
+    int wdl;
+    if (probeTablebaseWDL(pos, whiteToMove, &wdl) && wdl != TB_ILLEGAL) {
+        if (wdl == TB_DRAW) return 0;
+        return (wdl == TB_WIN) ? TB_WIN_SCORE - ply : -(TB_WIN_SCORE - ply);
     }
     
-    // Probe transposition table
+    // Probe transposition table (scores are for the side to move)
     TTEntry* ttEntry = probeTranspositionTable(hash);
-    Move* hashMove = NULL;
+    Move hashMove = MOVE_NONE;
+    if (ttEntry != NULL) {
+        // A shallower entry still suggests the move to try first
+        hashMove = ttEntry->bestMove;
+    }
     if (ttEntry != NULL && ttEntry->depth >= depth) {
         // Use stored score if depth is sufficient
         if (ttEntry->flag == TT_EXACT) {
@@ -281,137 +322,181 @@ int minimax(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], GameState* state, int de
         } else if (ttEntry->flag == TT_BETA && ttEntry->score >= beta) {
             return beta;
         }
-        hashMove = &ttEntry->bestMove;
     }
     
     // Base case: reached depth limit, switch to quiescence search
     if (depth == 0) {
-        return quiescenceSearch(board, state, alpha, beta, maximizing, 
+        return quiescenceSearch(pos, alpha, beta, whiteToMove, 
                                nodesEvaluated, startTime, ply);
     }
     
-    Move moves[MAX_MOVES];
-    int numMoves = generateAllLegalMoves(board, maximizing, moves, state);
+    // Shallow pruning only happens in null-window nodes, out of check, and
+    // judges the node by its static evaluation
+    int inCheck = isInCheck(pos, whiteToMove);
+    int pvNode = beta - alpha > 1;
+    int staticEval = inCheck ? 0 : evaluateForSide(pos, whiteToMove);
+    int canPrune = !pvNode && !inCheck;
     
-    // Sort moves for better pruning
-    sortMoves(board, moves, numMoves, hashMove, ply);
+    // Reverse futility (static null move): so far above beta that no reply
+    // will bring the score back within the margin
+    if (canPrune && depth <= FUTILITY_MAX_DEPTH && beta < MATE_SCORE_THRESHOLD &&
+        staticEval - reverseFutilityMargin[depth] >= beta) {
+        pruneStats.reverseFutility++;
+        return beta;
+    }
     
-    Move bestMove = moves[0];
-    int originalAlpha = alpha;
+    // Razoring: so far below alpha that only captures could help, so let
+    // quiescence decide
+    if (canPrune && depth <= RAZOR_MAX_DEPTH && staticEval + razorMargin[depth] <= alpha) {
+        int score = quiescenceSearch(pos, alpha, alpha + 1, whiteToMove, 
+                                     nodesEvaluated, startTime, ply);
+        if (score <= alpha) {
+            pruneStats.razoring++;
+            return score;
+        }
+    }
     
-    if (maximizing) {
-        int maxScore = INITIAL_ALPHA;
+    // Null-move pruning: if passing still fails high on a reduced search, a
+    // real move would too
+    if (canPrune && depth >= NULL_MOVE_MIN_DEPTH && !verifyingNullMove &&
+        !lastMoveWasNull(pos) && hasNonPawnMaterial(pos, whiteToMove) && staticEval >= beta) {
+        int nullDepth = depth - 1 - (NULL_MOVE_REDUCTION + depth / NULL_MOVE_DEPTH_DIVISOR);
+        if (nullDepth < 0) nullDepth = 0;
         
-        for (int i = 0; i < numMoves; i++) {
-            char savedStart, savedEnd, savedCaptured;
-            int wasEnPassant;
-            GameState savedState = *state;
-            
-            makeMove(board, &moves[i], &savedStart, &savedEnd, &savedCaptured, &wasEnPassant, state);
-            updateEnPassant(state, &moves[i], savedStart);
-            unsigned long long newHash = computeHash(board);
-            
-            int score;
-            
-            // Late Move Reduction (LMR) - search later moves at reduced depth
-            int reduction = 2;
-            if (i >= 4 && depth >= 3 && isEmpty(savedEnd) && !isKillerMove(&moves[i], ply)) {
-                int reducedDepth = depth - reduction;
-                if (reducedDepth <= 0) reducedDepth = 1;
-                // Search at reduced depth first
-                score = minimax(board, state, reducedDepth, alpha, beta, 0, 
-                               nodesEvaluated, newHash, startTime, ply + 1);
-                
-                // If it looks good, re-search at full depth
-                if (score > alpha) {
-                    score = minimax(board, state, depth - 1, alpha, beta, 0, 
-                                   nodesEvaluated, newHash, startTime, ply + 1);
-                }
-            } else {
-                // Normal full-depth search
-                score = minimax(board, state, depth - 1, alpha, beta, 0, 
-                               nodesEvaluated, newHash, startTime, ply + 1);
-            }
-            
-            unmakeMove(board, &moves[i], savedStart, savedEnd, savedCaptured, wasEnPassant, state);
-            *state = savedState;
-            
-            if (score > maxScore) {
-                maxScore = score;
-                bestMove = moves[i];
+        doNullMove(pos);
+        int score = -negamax(pos, nullDepth, -beta, -beta + 1, !whiteToMove, 
+                             nodesEvaluated, positionKey(pos, !whiteToMove), startTime, ply + 1);
+        undoNullMove(pos);
+        
+        if (score >= beta) {
+            // Deep cutoffs are confirmed by our own search at the same reduced
+            // depth, which catches the zugzwangs material alone does not predict
+            if (nullMoveVerification && depth >= NULL_MOVE_VERIFY_DEPTH) {
+                verifyingNullMove = 1;
+                score = negamax(pos, nullDepth, beta - 1, beta, whiteToMove, 
+                                nodesEvaluated, hash, startTime, ply);
+                verifyingNullMove = 0;
             }
-            
-            if (score > alpha) alpha = score;
-            
-            if (beta <= alpha) {
-                // Beta cutoff - store killer move if not a capture
-                if (isEmpty(savedEnd)) {
-                    storeKillerMove(&moves[i], ply);
-                }
-                break;
+            // Only a cutoff the verification confirms is taken
+            if (score >= beta) {
+                pruneStats.nullMove++;
+                return beta;
             }
         }
+    }
+    
+    // Futility pruning: quiet moves that cannot lift the score to alpha
+    int futile = canPrune && depth <= FUTILITY_MAX_DEPTH && alpha > -MATE_SCORE_THRESHOLD &&
+                 staticEval + futilityMargin[depth] <= alpha;
+    
+    // Moves are generated stage by stage, so a cutoff by the hash move or an
+    // early capture never pays for the quiet moves
+    MovePicker picker;
+    initMovePicker(&picker, pos, whiteToMove, hashMove, ply);
+    
+    Move move;
+    Move bestMove = MOVE_NONE;
+    int bestScore = INITIAL_ALPHA;
+    int movesSearched = 0;
+    int originalAlpha = alpha;
+    
+    // Quiet moves searched before a cutoff lose history
+    Move quietsSearched[MAX_MOVES];
+    int numQuiets = 0;
+    
+    while ((move = nextMove(&picker)) != MOVE_NONE) {
+        int isQuiet = isQuietMove(pos, move);
+        
+        // Late move pruning: past the move count, quiet moves are skipped
+        if (canPrune && isQuiet && depth <= LMP_MAX_DEPTH && movesSearched >= lmpMoveCount[depth] &&
+            alpha > -MATE_SCORE_THRESHOLD) {
+            pruneStats.lateMove++;
+            continue;
+        }
         
-        // Store in transposition table
-        int flag = (maxScore <= originalAlpha) ? TT_ALPHA : 
-                   (maxScore >= beta) ? TT_BETA : TT_EXACT;
-        storeTranspositionTable(hash, depth, maxScore, flag, &bestMove);
+        doMove(pos, move);
+        int givesCheck = isInCheck(pos, !whiteToMove);
         
-        return maxScore;
+        // Checking moves are kept, they may change the picture entirely
+        if (futile && isQuiet && movesSearched > 0 && !givesCheck) {
+            undoMove(pos);
+            pruneStats.futility++;
+            continue;
+        }
         
-    } else {
-        int minScore = INITIAL_BETA;
+        unsigned long long newHash = positionKey(pos, !whiteToMove);
         
-        for (int i = 0; i < numMoves; i++) {
-            char savedStart, savedEnd, savedCaptured;
-            int wasEnPassant;
-            GameState savedState = *state;
-            
-            makeMove(board, &moves[i], &savedStart, &savedEnd, &savedCaptured, &wasEnPassant, state);
-            updateEnPassant(state, &moves[i], savedStart);
-            unsigned long long newHash = computeHash(board);
-            
-            int score;
-            
-            // Late Move Reduction
-            int reduction = 2;
-            if (i >= 4 && depth >= 3 && isEmpty(savedEnd) && !isKillerMove(&moves[i], ply)) {
-                int reducedDepth = depth - reduction;
-                if (reducedDepth <= 0) reducedDepth = 1;
-                score = minimax(board, state, reducedDepth, alpha, beta, 1, 
-                               nodesEvaluated, newHash, startTime, ply + 1);
+        int score;
+        if (movesSearched == 0) {
+            score = -negamax(pos, depth - 1, -beta, -alpha, !whiteToMove, 
+                             nodesEvaluated, newHash, startTime, ply + 1);
+        } else {
+            // Late Move Reduction (LMR) - later quiet moves are searched shallower
+            int searchDepth = depth - 1;
+            if (isQuiet && !inCheck && depth >= LMR_MIN_DEPTH) {
+                int reduction = lmrTable[depth < LMR_MAX_DEPTH ? depth : LMR_MAX_DEPTH - 1]
+                                        [movesSearched < LMR_MAX_MOVES ? movesSearched : LMR_MAX_MOVES - 1];
+                if (pvNode) reduction--;
+                if (givesCheck) reduction--;
+                if (isKillerMove(move, ply)) reduction--;
+                reduction -= getHistoryScore(whiteToMove, move) * LMR_HISTORY_PLIES / HISTORY_MAX;
                 
-                if (score < beta) {
-                    score = minimax(board, state, depth - 1, alpha, beta, 1, 
-                                   nodesEvaluated, newHash, startTime, ply + 1);
-                }
-            } else {
-                score = minimax(board, state, depth - 1, alpha, beta, 1, 
-                               nodesEvaluated, newHash, startTime, ply + 1);
+                if (reduction > depth - 2) reduction = depth - 2;
+                if (reduction > 0) searchDepth -= reduction;
             }
+            score = -negamax(pos, searchDepth, -alpha - 1, -alpha, !whiteToMove, 
+                             nodesEvaluated, newHash, startTime, ply + 1);
             
-            unmakeMove(board, &moves[i], savedStart, savedEnd, savedCaptured, wasEnPassant, state);
-            *state = savedState;
-            
-            if (score < minScore) {
-                minScore = score;
-                bestMove = moves[i];
+            // A reduced move that beats alpha is verified at full depth
+            if (score > alpha && searchDepth < depth - 1) {
+                score = -negamax(pos, depth - 1, -alpha - 1, -alpha, !whiteToMove, 
+                                 nodesEvaluated, newHash, startTime, ply + 1);
             }
             
-            if (score < beta) beta = score;
-            
-            if (beta <= alpha) {
-                if (isEmpty(savedEnd)) {
-                    storeKillerMove(&moves[i], ply);
-                }
-                break;
+            // Inside the window: the move may be the new best, get its exact score
+            if (score > alpha && score < beta) {
+                score = -negamax(pos, depth - 1, -beta, -alpha, !whiteToMove, 
+                                 nodesEvaluated, newHash, startTime, ply + 1);
             }
         }
         
-        int flag = (minScore <= originalAlpha) ? TT_ALPHA : 
-                   (minScore >= beta) ? TT_BETA : TT_EXACT;
-        storeTranspositionTable(hash, depth, minScore, flag, &bestMove);
+        undoMove(pos);
+        movesSearched++;
+        
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+        }
+        
+        if (score > alpha) alpha = score;
         
-        return minScore;
+        if (alpha >= beta) {
+            // Beta cutoff - a quiet move becomes a killer and gains history,
+            // the quiets tried before it lose some
+            if (isQuiet) {
+                storeKillerMove(move, ply);
+                updateHistory(whiteToMove, move, depth * depth);
+                for (int i = 0; i < numQuiets; i++) {
+                    updateHistory(whiteToMove, quietsSearched[i], -depth * depth);
+                }
+            }
+            break;
+        }
+        
+        if (isQuiet && numQuiets < MAX_MOVES) {
+            quietsSearched[numQuiets++] = move;
+        }
+    }
+    
+    // No legal moves: checkmate (closer mates score higher) or stalemate
+    if (movesSearched == 0) {
+        return inCheck ? -MATE_SCORE + ply : 0;
     }
-}
\ No newline at end of file
+    
+    // Store in transposition table
+    int flag = (bestScore <= originalAlpha) ? TT_ALPHA : 
+               (bestScore >= beta) ? TT_BETA : TT_EXACT;
+    storeTranspositionTable(hash, depth, bestScore, flag, bestMove);
+    
+    return bestScore;
+}
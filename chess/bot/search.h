@@ -4,6 +4,7 @@
 #include <gameState.h>
 #include <time.h>
 #include <moves.h>
+#include <position.h>
 
 // Constants for magic numbers
 #define MAX_BOARD_SIZE 8
@@ -14,20 +15,83 @@
 #define MATE_SCORE 100000
 #define MATE_SCORE_THRESHOLD 90000
 
-// UPDATED: Added GameState* parameter to makeMove and unmakeMove
-void makeMove(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Move* move, char* savedStart, char* savedEnd, 
-              char* savedCaptured, int* wasEnPassant, GameState* state);
+// Make/unmake on the search position. doMove pushes an undo record and keeps
+// the bitboards, mailbox, castling, en passant and hash in sync; undoMove pops it.
+void doMove(Position* pos, Move move);
 
-void unmakeMove(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], Move* move, char savedStart, char savedEnd, 
-                char savedCaptured, int wasEnPassant, GameState* state);
+void undoMove(Position* pos);
 
-void updateEnPassant(GameState* state, Move* move, char piece);
+// Pass the turn (null move): clears en passant in the position and its hash and
+// pushes an undo record with MOVE_NONE. The side to move lives in positionKey().
+void doNullMove(Position* pos);
+void undoNullMove(Position* pos);
 
-int quiescenceSearch(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], GameState* state, int alpha, int beta, 
-                     int maximizing, int* nodesEvaluated, clock_t startTime, int ply);
+// Null-move pruning: reduction NULL_MOVE_REDUCTION + depth / NULL_MOVE_DEPTH_DIVISOR.
+// At NULL_MOVE_VERIFY_DEPTH and deeper a cutoff is confirmed by a reduced
+// search without null moves while nullMoveVerification is set.
+#define NULL_MOVE_MIN_DEPTH 3
+#define NULL_MOVE_REDUCTION 2
+#define NULL_MOVE_DEPTH_DIVISOR 4
+#define NULL_MOVE_VERIFY_DEPTH 8
 
-int minimax(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE], GameState* state, int depth, int alpha, int beta, 
-            int maximizing, int* nodesEvaluated, unsigned long long hash,
+extern int nullMoveVerification;
+
+// Shallow-depth pruning in null-window nodes, margins by remaining depth:
+// reverse futility returns when eval - margin >= beta, futility skips quiet
+// non-checking moves when eval + margin <= alpha, razoring drops into
+// quiescence when eval + margin <= alpha
+#define FUTILITY_MAX_DEPTH 3
+#define RAZOR_MAX_DEPTH 2
+
+extern int reverseFutilityMargin[FUTILITY_MAX_DEPTH + 1];
+extern int futilityMargin[FUTILITY_MAX_DEPTH + 1];
+extern int razorMargin[RAZOR_MAX_DEPTH + 1];
+
+// Late move reductions for quiet moves, in plies by depth and move number:
+// lmrBase + ln(depth) * ln(moves) / lmrDivisor, then one less at PV nodes,
+// for checking moves and killers, and up to LMR_HISTORY_PLIES less or more
+// by history score. Reduced moves get a null window and a full-depth re-search
+// when they beat alpha.
+#define LMR_MAX_DEPTH 64
+#define LMR_MAX_MOVES 64
+#define LMR_MIN_DEPTH 3
+#define LMR_HISTORY_PLIES 2
+
+// Late move pruning: in null-window nodes up to LMP_MAX_DEPTH, quiet moves
+// after the first lmpBase + depth * depth * lmpScale / 2 are not searched
+#define LMP_MAX_DEPTH 4
+
+extern int lmrTable[LMR_MAX_DEPTH][LMR_MAX_MOVES];
+extern int lmpMoveCount[LMP_MAX_DEPTH + 1];
+
+// Rebuild the tables with new parameters (defaults 0.75, 2.25 and 3, 2);
+// entries can also be tuned directly once built
+void setReductionParameters(double lmrBase, double lmrDivisor);
+void setMoveCountPruning(int lmpBase, int lmpScale);
+
+// Build both tables with the defaults unless they were already set
+void initSearchTables(void);
+
+// Nodes (or, for futility, late move pruning and SEE, moves) removed by each
+// technique since the last reset
+typedef struct {
+    unsigned long long reverseFutility;
+    unsigned long long futility;
+    unsigned long long razoring;
+    unsigned long long nullMove;
+    unsigned long long lateMove;
+    unsigned long long badCaptures;  // Negative-SEE captures skipped in quiescence
+} PruneStats;
+
+void getPruneStats(PruneStats* stats);
+void resetPruneStats(void);
+
+// Searches return scores from the side to move's point of view
+int quiescenceSearch(Position* pos, int alpha, int beta, 
+                     int whiteToMove, int* nodesEvaluated, clock_t startTime, int ply);
+
+int negamax(Position* pos, int depth, int alpha, int beta, 
+            int whiteToMove, int* nodesEvaluated, unsigned long long hash,
             clock_t startTime, int ply);
 
 #endif
\ No newline at end of file
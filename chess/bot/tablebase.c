@@ -0,0 +1,351 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <tablebase.h>
+#include <bitboard.h>
+
+static const char pieceLetters[] = "KQRBNP";
+static const int pieceTypes[6] = {KING, QUEEN, ROOK, BISHOP, KNIGHT, PAWN};
+static const int pieceStrength[6] = {0, 9, 5, 3, 3, 1};  // By letter, to pick the stronger side
+
+// ============================================================================
+// NAMES
+// ============================================================================
+
+static int letterOrder(char c) {
+    const char* p = strchr(pieceLetters, c);
+    return (p != NULL && c != '\0') ? (int)(p - pieceLetters) : -1;
+}
+
+static int compareLetters(const void* a, const void* b) {
+    return letterOrder(*(const char*)a) - letterOrder(*(const char*)b);
+}
+
+// Rank two sides: more material first, then more men, then by piece order
+static int strongerSide(const char* a, const char* b) {
+    int strengthA = 0, strengthB = 0;
+    for (int i = 0; a[i]; i++) strengthA += pieceStrength[letterOrder(a[i])];
+    for (int i = 0; b[i]; i++) strengthB += pieceStrength[letterOrder(b[i])];
+    if (strengthA != strengthB) return strengthA > strengthB;
+    if (strlen(a) != strlen(b)) return strlen(a) > strlen(b);
+    for (int i = 0; a[i]; i++) {
+        if (a[i] != b[i]) return letterOrder(a[i]) < letterOrder(b[i]);
+    }
+    return 1;
+}
+
+int parseTablebaseName(const char* name, Tablebase* tb) {
+    int length = (int)strlen(name);
+    if (length < 2 || length > TB_MAX_PIECES || name[0] != 'K') return 0;
+
+    const char* second = strchr(name + 1, 'K');
+    if (second == NULL || strchr(second + 1, 'K') != NULL) return 0;
+    for (int i = 0; i < length; i++) {
+        if (letterOrder(name[i]) < 0) return 0;
+    }
+
+    char sides[2][TB_MAX_PIECES + 1];
+    int firstLength = (int)(second - name);
+    memcpy(sides[0], name, firstLength);
+    sides[0][firstLength] = '\0';
+    strcpy(sides[1], second);
+    qsort(sides[0], strlen(sides[0]), 1, compareLetters);
+    qsort(sides[1], strlen(sides[1]), 1, compareLetters);
+
+    int strong = strongerSide(sides[0], sides[1]) ? 0 : 1;
+    memset(tb, 0, sizeof(*tb));
+    snprintf(tb->name, sizeof(tb->name), "%s%s", sides[strong], sides[!strong]);
+
+    int counts[2][NUM_PIECE_TYPES] = {{0}};
+    for (int i = 0; tb->name[i]; i++) {
+        int color = (i < (int)strlen(sides[strong])) ? COLOR_WHITE : COLOR_BLACK;
+        int piece = PIECE_INDEX(color, pieceTypes[letterOrder(tb->name[i])]);
+        tb->pieces[tb->numPieces++] = piece;
+        counts[0][piece]++;
+        counts[1][(piece + 6) % NUM_PIECE_TYPES]++;
+        if (piece % 6 == PAWN) tb->hasPawns = 1;
+    }
+
+    initZobrist();
+    tb->keys[0] = materialKeyOf(counts[0]);
+    tb->keys[1] = materialKeyOf(counts[1]);
+
+    // The white king is reduced to a-d (pawns) or the a1-d1-d4 triangle
+    tb->size = tb->hasPawns ? 32 : 10;
+    for (int i = 1; i < tb->numPieces; i++) tb->size *= 64;
+    return 1;
+}
+
+// ============================================================================
+// INDEXING
+// ============================================================================
+
+// Squares counted from white's side: file and rank, 0-7
+#define FILE_OF(sq) SQUARE_COL(sq)
+#define RANK_OF(sq) (7 - SQUARE_ROW(sq))
+
+static int transpose(int square) {
+    return SQUARE(7 - FILE_OF(square), RANK_OF(square));
+}
+
+// Bring the white king into its reduced region, and settle ties on the
+// a1-h8 diagonal by the first man off it
+static void canonicalize(const Tablebase* tb, int squares[]) {
+    int n = tb->numPieces;
+    if (FILE_OF(squares[0]) > 3) {
+        for (int i = 0; i < n; i++) squares[i] ^= 7;
+    }
+    if (tb->hasPawns) return;
+
+    if (RANK_OF(squares[0]) > 3) {
+        for (int i = 0; i < n; i++) squares[i] ^= 56;
+    }
+    int flip = RANK_OF(squares[0]) > FILE_OF(squares[0]);
+    if (RANK_OF(squares[0]) == FILE_OF(squares[0])) {
+        for (int i = 1; i < n; i++) {
+            if (RANK_OF(squares[i]) != FILE_OF(squares[i])) {
+                flip = RANK_OF(squares[i]) > FILE_OF(squares[i]);
+                break;
+            }
+        }
+    }
+    if (flip) {
+        for (int i = 0; i < n; i++) squares[i] = transpose(squares[i]);
+    }
+}
+
+// a1, b1, c1, d1, b2, c2, d2, c3, d3, d4 as file/rank pairs
+static const int triangle[10][2] = {
+    {0, 0}, {1, 0}, {2, 0}, {3, 0}, {1, 1}, {2, 1}, {3, 1}, {2, 2}, {3, 2}, {3, 3}
+};
+
+static int kingRegion(const Tablebase* tb, int square) {
+    if (tb->hasPawns) return RANK_OF(square) * 4 + FILE_OF(square);
+    for (int i = 0; i < 10; i++) {
+        if (triangle[i][0] == FILE_OF(square) && triangle[i][1] == RANK_OF(square)) return i;
+    }
+    return -1;
+}
+
+long tablebaseIndex(const Tablebase* tb, const int squares[]) {
+    int reduced[TB_MAX_PIECES];
+    memcpy(reduced, squares, tb->numPieces * sizeof(int));
+    canonicalize(tb, reduced);
+
+    long index = kingRegion(tb, reduced[0]);
+    for (int i = 1; i < tb->numPieces; i++) index = index * 64 + reduced[i];
+    return index;
+}
+
+int tablebaseSquares(const Tablebase* tb, long index, int squares[]) {
+    for (int i = tb->numPieces - 1; i >= 1; i--) {
+        squares[i] = (int)(index & 63);
+        index >>= 6;
+    }
+    int region = (int)index;
+    if (tb->hasPawns) {
+        squares[0] = SQUARE(7 - region / 4, region % 4);
+    } else {
+        squares[0] = SQUARE(7 - triangle[region][1], triangle[region][0]);
+    }
+
+    int reduced[TB_MAX_PIECES];
+    memcpy(reduced, squares, tb->numPieces * sizeof(int));
+    canonicalize(tb, reduced);
+    return memcmp(reduced, squares, tb->numPieces * sizeof(int)) == 0;
+}
+
+// ============================================================================
+// LOADING
+// ============================================================================
+
+typedef struct {
+    unsigned long long key;
+    Tablebase* tb;
+    int flipped;  // Colors are the other way round from the table
+} TablebaseSlot;
+
+#define TB_SLOTS 512  // Power of two, two keys per table
+
+static Tablebase tables[TB_MAX_TABLES];
+static int numTables = 0;
+static int largestTable = 0;  // Most pieces of any loaded ending
+static TablebaseSlot slots[TB_SLOTS];
+
+static unsigned long long tbProbes = 0;
+static unsigned long long tbHits = 0;
+static unsigned long long tbNanoseconds = 0;
+
+// Map a file and check its header; NULL if missing or the wrong size
+static const unsigned char* mapTableFile(const char* path, const char* magic, size_t dataSize) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    const unsigned char* data = NULL;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size == TB_HEADER_SIZE + dataSize) {
+        void* mapped = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped != MAP_FAILED) {
+            data = (const unsigned char*)mapped;
+            if (memcmp(data, magic, 8) != 0) {
+                munmap(mapped, st.st_size);
+                data = NULL;
+            }
+        }
+    }
+    close(fd);
+    return data ? data + TB_HEADER_SIZE : NULL;
+}
+
+static void addSlot(unsigned long long key, Tablebase* tb, int flipped) {
+    int slot = key & (TB_SLOTS - 1);
+    while (slots[slot].key != 0 && slots[slot].key != key) {
+        slot = (slot + 1) & (TB_SLOTS - 1);
+    }
+    slots[slot].key = key;
+    slots[slot].tb = tb;
+    slots[slot].flipped = flipped;
+}
+
+int loadTablebase(const char* dir, const char* name) {
+    Tablebase parsed;
+    if (numTables >= TB_MAX_TABLES || !parseTablebaseName(name, &parsed)) return 0;
+    for (int i = 0; i < numTables; i++) {
+        if (strcmp(tables[i].name, parsed.name) == 0) return 1;
+    }
+
+    char path[512];
+    size_t entries = 2 * (size_t)parsed.size;
+    snprintf(path, sizeof(path), "%s/%s.wdl", dir, parsed.name);
+    parsed.wdl = mapTableFile(path, TB_WDL_MAGIC, (entries + 3) / 4);
+    snprintf(path, sizeof(path), "%s/%s.dtm", dir, parsed.name);
+    parsed.dtm = mapTableFile(path, TB_DTM_MAGIC, entries);
+    if (parsed.wdl == NULL || parsed.dtm == NULL) return 0;
+
+    Tablebase* tb = &tables[numTables++];
+    *tb = parsed;
+    addSlot(tb->keys[0], tb, 0);
+    // Symmetric endings (KRKR) have one key; the unflipped slot serves both
+    if (tb->keys[1] != tb->keys[0]) addSlot(tb->keys[1], tb, 1);
+    if (tb->numPieces > largestTable) largestTable = tb->numPieces;
+    return 1;
+}
+
+int initTablebases(const char* dir) {
+    DIR* handle = opendir(dir);
+    if (handle == NULL) return 0;
+
+    int loaded = 0;
+    struct dirent* entry;
+    while ((entry = readdir(handle)) != NULL) {
+        char name[16];
+        const char* dot = strrchr(entry->d_name, '.');
+        size_t length = dot ? (size_t)(dot - entry->d_name) : 0;
+        if (dot == NULL || strcmp(dot, ".wdl") != 0 || length >= sizeof(name)) continue;
+        memcpy(name, entry->d_name, length);
+        name[length] = '\0';
+        loaded += loadTablebase(dir, name);
+    }
+    closedir(handle);
+    return loaded;
+}
+
+// ============================================================================
+// PROBING
+// ============================================================================
+
+// Table and entry number of a position, -1 if its ending is not loaded.
+// The tables have no en passant or castling, so positions that allow either are not found.
+static long locate(Position* pos, int whiteToMove, Tablebase** found) {
+    if (pos->castling != 0) return -1;
+    if (pos->epSquare != NO_SQUARE) {
+        int us = whiteToMove ? COLOR_WHITE : COLOR_BLACK;
+        // Only a pawn that can actually take en passant matters
+        if (pawnAttacks[!us][pos->epSquare] & pos->pieces[PIECE_INDEX(us, PAWN)]) return -1;
+    }
+
+    int slot = pos->materialKey & (TB_SLOTS - 1);
+    while (slots[slot].key != 0 && slots[slot].key != pos->materialKey) {
+        slot = (slot + 1) & (TB_SLOTS - 1);
+    }
+    if (slots[slot].key == 0) return -1;
+
+    Tablebase* tb = slots[slot].tb;
+    int flipped = slots[slot].flipped;
+    int squares[TB_MAX_PIECES];
+    int used[NUM_PIECE_TYPES] = {0};
+    for (int i = 0; i < tb->numPieces; i++) {
+        // Flipping swaps the colors and mirrors the ranks
+        int piece = flipped ? (tb->pieces[i] + 6) % NUM_PIECE_TYPES : tb->pieces[i];
+        squares[i] = pos->pieceList[piece][used[piece]++];
+        if (flipped) squares[i] ^= 56;
+    }
+    int sideToMove = (whiteToMove != flipped) ? 0 : 1;
+    *found = tb;
+    return sideToMove * tb->size + tablebaseIndex(tb, squares);
+}
+
+static unsigned long long nanosecondsNow(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+int probeTablebaseWDL(Position* pos, int whiteToMove, int* wdl) {
+    int men = popCount(pos->occupied);
+    if (men > largestTable) return 0;
+
+    tbProbes++;
+    if (men == 2) {
+        tbHits++;
+        *wdl = TB_DRAW;
+        return 1;
+    }
+
+    unsigned long long start = nanosecondsNow();
+    Tablebase* tb;
+    long entry = locate(pos, whiteToMove, &tb);
+    if (entry < 0) return 0;
+
+    *wdl = (tb->wdl[entry / 4] >> ((entry % 4) * 2)) & 3;
+    tbHits++;
+    tbNanoseconds += nanosecondsNow() - start;
+    return 1;
+}
+
+int probeTablebaseDTM(Position* pos, int whiteToMove, int* wdl, int* plies) {
+    if (popCount(pos->occupied) == 2) {
+        *wdl = TB_DRAW;
+        *plies = 0;
+        return 1;
+    }
+
+    Tablebase* tb;
+    long entry = locate(pos, whiteToMove, &tb);
+    if (entry < 0) return 0;
+
+    // Stored as plies plus one: wins are an odd number of plies away, losses even
+    int stored = tb->dtm[entry];
+    *plies = stored ? stored - 1 : 0;
+    *wdl = stored == 0 ? TB_DRAW : (*plies % 2) ? TB_WIN : TB_LOSS;
+    return 1;
+}
+
+void getTablebaseStats(unsigned long long* probes, unsigned long long* hits,
+                       unsigned long long* nanoseconds) {
+    *probes = tbProbes;
+    *hits = tbHits;
+    *nanoseconds = tbNanoseconds;
+}
+
+void resetTablebaseStats(void) {
+    tbProbes = 0;
+    tbHits = 0;
+    tbNanoseconds = 0;
+}
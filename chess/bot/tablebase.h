@@ -0,0 +1,65 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include <position.h>
+
+// Endgame tablebases written by the tbgen tool and memory-mapped by the engine.
+// Each ending has a .wdl file (2 bits per position: result for the side to move)
+// and a .dtm file (1 byte per position: plies to mate plus one, 0 for draws).
+#define TB_MAX_PIECES 4
+#define TB_MAX_TABLES 160
+#define TB_DEFAULT_PATH "tablebases"
+
+// Score of a tablebase win in the search, above known wins and below mates
+#define TB_WIN_SCORE 50000
+
+// Results, from the side to move
+#define TB_DRAW 0
+#define TB_WIN 1
+#define TB_LOSS 2
+#define TB_ILLEGAL 3
+
+#define TB_WDL_MAGIC "CHTBWDL1"
+#define TB_DTM_MAGIC "CHTBDTM1"
+#define TB_HEADER_SIZE 16  // Magic plus the 64-bit number of entries
+
+// One ending, named by its pieces with the stronger side first ("KQKR").
+// The first side is white in the table; positions with the colors the other
+// way round are probed with the board flipped.
+typedef struct {
+    char name[TB_MAX_PIECES + 1];
+    int numPieces;
+    int pieces[TB_MAX_PIECES];   // Piece index per slot: white king, white men, black king, black men
+    int hasPawns;
+    long size;                   // Positions per side to move
+    unsigned long long keys[2];  // Material key with the first side white, then black
+    const unsigned char* wdl;    // Mapped entries, NULL until loaded
+    const unsigned char* dtm;
+} Tablebase;
+
+// Fill in a table's layout from its name; 0 if the name is not a valid ending.
+// The name is normalized (stronger side first, pieces in KQRBNP order).
+int parseTablebaseName(const char* name, Tablebase* tb);
+
+// Index of a placement (squares per slot), after reducing it by symmetry
+long tablebaseIndex(const Tablebase* tb, const int squares[]);
+
+// Placement of an index; 0 if the index is not the canonical form of its position
+int tablebaseSquares(const Tablebase* tb, long index, int squares[]);
+
+// Map one ending from a directory, or every ending found there
+int loadTablebase(const char* dir, const char* name);
+int initTablebases(const char* dir);
+
+// Probes by material key; 1 if the position's ending is loaded (or only kings are left).
+// Positions with castling rights, or where a pawn can capture en passant, are never found.
+// Results are for the side to move, DTM in plies (0 when mated or drawn).
+int probeTablebaseWDL(Position* pos, int whiteToMove, int* wdl);
+int probeTablebaseDTM(Position* pos, int whiteToMove, int* wdl, int* plies);
+
+// WDL probe counts and time spent in hits since the last reset
+void getTablebaseStats(unsigned long long* probes, unsigned long long* hits,
+                       unsigned long long* nanoseconds);
+void resetTablebaseStats(void);
+
+#endif
@@ -4,54 +4,9 @@
 #include <moves.h>
 #include <board.h>
 
-// Zobrist hashing for position identification
-static unsigned long long zobristTable[MAX_BOARD_SIZE][MAX_BOARD_SIZE][MAX_PIECE_TYPES];
-static int zobristInitialized = 0;
-
 static TTEntry* transpositionTable = NULL;
 static int transpositionTableInitialized = 0;
 
-// Initialize Zobrist random numbers
-void initZobrist(void) {
-    if (zobristInitialized) return;
-    
-    srand(INITIAL_SEED);  // Fixed seed for consistency
-    for (int row = 0; row < MAX_BOARD_SIZE; row++) {
-        for (int col = 0; col < MAX_BOARD_SIZE; col++) {
-            for (int piece = 0; piece < MAX_PIECE_TYPES; piece++) {
-                zobristTable[row][col][piece] = 
-                    ((unsigned long long)rand() << 32) | rand();
-            }
-        }
-    }
-    zobristInitialized = 1;
-}
-
-// Map piece character to index (0-11)
-int pieceToIndex(char piece) {
-    const char* pieces = "PNBRQKpnbrqk";
-    for (int i = 0; i < MAX_PIECE_TYPES; i++) {
-        if (pieces[i] == piece) return i;
-    }
-    return -1;
-}
-
-// Compute hash for current board position
-unsigned long long computeHash(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE]) {
-    unsigned long long hash = 0;
-    for (int row = 0; row < MAX_BOARD_SIZE; row++) {
-        for (int col = 0; col < MAX_BOARD_SIZE; col++) {
-            if (!isEmpty(board[row][col])) {
-                int idx = pieceToIndex(board[row][col]);
-                if (idx >= 0) {
-                    hash ^= zobristTable[row][col][idx];
-                }
-            }
-        }
-    }
-    return hash;
-}
-
 // Initialize transposition table
 int initTranspositionTable(void) {
     if (transpositionTable == NULL) {
@@ -88,7 +43,7 @@ TTEntry* probeTranspositionTable(unsigned long long hash) {
 
 // Store in transposition table
 void storeTranspositionTable(unsigned long long hash, int depth, int score, 
-                             int flag, Move* bestMove) {
+                             int flag, Move bestMove) {
     if (!transpositionTableInitialized) return;
     
     int index = hash % TT_SIZE;
@@ -100,8 +55,6 @@ void storeTranspositionTable(unsigned long long hash, int depth, int score,
         entry->depth = depth;
         entry->score = score;
         entry->flag = flag;
-        if (bestMove) {
-            entry->bestMove = *bestMove;
-        }
+        entry->bestMove = bestMove;
     }
 }
\ No newline at end of file
@@ -3,34 +3,27 @@
 
 #include <gameState.h>
 #include <moves.h>
+#include <position.h>
 
 // Constants for magic numbers
 #define MAX_BOARD_SIZE 8
 #define MAX_PIECE_TYPES 12
-#define INITIAL_SEED 12345
 
 // Transposition table entry
 typedef struct {
     unsigned long long hash;
-    int depth;
     int score;
-    int flag;  // 0 = exact, 1 = lower bound (alpha), 2 = upper bound (beta)
-    Move bestMove;
+    Move bestMove;      // MOVE_NONE if not known
+    signed char depth;
+    unsigned char flag;  // 0 = exact, 1 = lower bound (alpha), 2 = upper bound (beta)
 } TTEntry;
 
-#define TT_SIZE 1048576  // 1M entries (about 32MB)
+#define TT_SIZE 1048576  // 1M entries (16 bytes each, about 16MB)
 #define TT_EXACT 0
 #define TT_ALPHA 1
 #define TT_BETA 2
 
-// Initialize Zobrist random numbers
-void initZobrist(void);
-
-// Map piece character to index (0-11)
-int pieceToIndex(char piece);
-
-// Compute hash for current board position
-unsigned long long computeHash(char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE]);
+// Positions are keyed by positionKey(); the Zobrist keys live in position.c
 
 // Initialize transposition table
 int initTranspositionTable(void);
@@ -43,6 +36,6 @@ TTEntry* probeTranspositionTable(unsigned long long hash);
 
 // Store in transposition table
 void storeTranspositionTable(unsigned long long hash, int depth, int score, 
-                             int flag, Move* bestMove);
+                             int flag, Move bestMove);
 
 #endif
\ No newline at end of file
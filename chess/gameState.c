@@ -15,29 +15,56 @@ void initializeGameState(GameState* state) {
     state->moveNumber = 1;
 }
 
+static const int knightProbes[8][2] = {
+    {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2},
+    {1, -2}, {1, 2}, {2, -1}, {2, 1}
+};
+
+// First four are orthogonal (rook) rays, last four diagonal (bishop) rays
+static const int rayProbes[8][2] = {
+    {-1, 0}, {1, 0}, {0, -1}, {0, 1},
+    {-1, -1}, {-1, 1}, {1, -1}, {1, 1}
+};
+
+static int isPieceAt(char board[8][8], int row, int col, char piece) {
+    return row >= 0 && row < 8 && col >= 0 && col < 8 && board[row][col] == piece;
+}
+
+// Probe outward from the target square for each way it can be attacked,
+// stopping every slider ray at its first blocker
 int isSquareAttacked(char board[8][8], int row, int col, int byWhite, GameState* state) {
-    // Check if any piece of the attacking color can move to this square
-    for (int r = 0; r < 8; r++) {
-        for (int c = 0; c < 8; c++) {
+    (void)state;  // Attacks don't depend on castling or en passant rights
+    char pawn = byWhite ? 'P' : 'p';
+    char knight = byWhite ? 'N' : 'n';
+    char bishop = byWhite ? 'B' : 'b';
+    char rook = byWhite ? 'R' : 'r';
+    char queen = byWhite ? 'Q' : 'q';
+    char king = byWhite ? 'K' : 'k';
+    
+    // White pawns attack towards row 0, so they sit one row below the target
+    int pawnRow = byWhite ? row + 1 : row - 1;
+    if (isPieceAt(board, pawnRow, col - 1, pawn) || isPieceAt(board, pawnRow, col + 1, pawn)) {
+        return 1;
+    }
+    
+    for (int i = 0; i < 8; i++) {
+        if (isPieceAt(board, row + knightProbes[i][0], col + knightProbes[i][1], knight)) return 1;
+        if (isPieceAt(board, row + rayProbes[i][0], col + rayProbes[i][1], king)) return 1;
+    }
+    
+    for (int i = 0; i < 8; i++) {
+        char slider = (i < 4) ? rook : bishop;
+        int r = row + rayProbes[i][0];
+        int c = col + rayProbes[i][1];
+        
+        while (r >= 0 && r < 8 && c >= 0 && c < 8) {
             char piece = board[r][c];
-            if (isEmpty(piece)) continue;
-            
-            // Check if piece belongs to attacking color
-            int isPieceWhite = isWhitePiece(piece);
-            if (isPieceWhite != byWhite) continue;
-            
-            // For kings, only check adjacent squares (no castling in attack detection)
-            if (toupper(piece) == 'K') {
-                int rowDiff = abs(row - r);
-                int colDiff = abs(col - c);
-                if (rowDiff <= 1 && colDiff <= 1) return 1;
-                continue;
-            }
-            
-            // Check if this piece can legally move to the target square
-            if (canPieceMoveTo(board, r, c, row, col, state)) {
-                return 1;
+            if (!isEmpty(piece)) {
+                if (piece == slider || piece == queen) return 1;
+                break;  // Ray blocked
             }
+            r += rayProbes[i][0];
+            c += rayProbes[i][1];
         }
     }
     return 0;
@@ -4,11 +4,14 @@
 #include <time.h>
 #include <ctype.h>
 #include "board.h"
+#include "bitboard.h"
 #include "moves.h"
 #include "gameState.h"
 #include "bot/bot.h"  // INCLUDE BOT.H FROM THE BOT SUBDIRECTORY
 #include "timeControl.h"
 #include "evaluation.h"
+#include "nnue.h"
+#include "tablebase.h"
 
 // ============================================================================
 // GAME MODES
@@ -77,16 +80,16 @@ static void handleCastling(char board[8][8], int startCol, int endRow, int endCo
     }
 }
 
-static void handlePawnPromotion(char board[8][8], int endRow, int endCol, int isBotMove) {
+static void handlePawnPromotion(char board[8][8], int endRow, int endCol, char botPromotion) {
     char piece = board[endRow][endCol];
     
     if (toupper(piece) != 'P') return;
     if (endRow != 0 && endRow != 7) return;
     
-    if (isBotMove) {
-        // Bot always promotes to queen
-        board[endRow][endCol] = (endRow == 0) ? 'Q' : 'q';
-        printf("Pawn promoted to Queen!\n");
+    if (botPromotion) {
+        // Bot's piece comes from the promotion flags of its move
+        board[endRow][endCol] = (endRow == 0) ? botPromotion : tolower(botPromotion);
+        printf("Pawn promoted to %c!\n", botPromotion);
     } else {
         // Player chooses promotion piece
         printf("Pawn promotion! Choose piece (Q/R/B/N): ");
@@ -113,8 +116,9 @@ static void updateEnPassantState(GameState* state, char board[8][8],
     }
 }
 
+// botPromotion is the bot's promotion piece ('Q', 'R', 'B', 'N'), 0 asks the player
 static void executeMove(char board[8][8], GameState* state, int startRow, int startCol, 
-                       int endRow, int endCol, int isBotMove) {
+                       int endRow, int endCol, int isBotMove, char botPromotion) {
     printf("Move executed: %c from %c%d to %c%d\n", 
            board[startRow][startCol], 
            'a' + startCol, 8 - startRow, 
@@ -127,7 +131,7 @@ static void executeMove(char board[8][8], GameState* state, int startRow, int st
     board[startRow][startCol] = '.';
     
     handleCastling(board, startCol, endRow, endCol);
-    handlePawnPromotion(board, endRow, endCol, isBotMove);
+    handlePawnPromotion(board, endRow, endCol, isBotMove ? botPromotion : 0);
     
     updateCastlingRights(state, board, startRow, startCol, endRow, endCol);
     updateEnPassantState(state, board, startRow, endRow, endCol);
@@ -158,6 +162,16 @@ static int parseMove(char* input, int* startRow, int* startCol, int* endRow, int
     return 1;
 }
 
+// Swap between the classic evaluator and the network, if one was loaded
+static void toggleEvaluator(void) {
+    int next = (activeEvaluator == EVALUATOR_CLASSIC) ? EVALUATOR_NNUE : EVALUATOR_CLASSIC;
+    if (!setEvaluator(next)) {
+        printf("No network loaded (start with: ./chess <network file>)\n");
+        return;
+    }
+    printf("Evaluator: %s\n", next == EVALUATOR_NNUE ? "nnue" : "classic");
+}
+
 static int isBotTurn(int gameMode, int whiteToMove) {
     if (gameMode == MODE_BVB) return 1;
     if (gameMode == MODE_PVB_WHITE && !whiteToMove) return 1;
@@ -233,6 +247,7 @@ static int selectGameMode() {
     printf("- 'bvb' : Bot vs Bot\n");
     printf("- 'next' : Advance to next bot move (manual mode)\n");
     printf("- 'time' : Display remaining time\n");
+    printf("- 'eval' : Switch between classic and network evaluation\n");
     printf("- 'quit' : Exit\n");
     printf("- Move format: e2e4\n\n");
     
@@ -305,9 +320,27 @@ static int handleModeChange(char* input, int* gameMode) {
 // MAIN GAME LOOP
 // ============================================================================
 
-int main() {
+int main(int argc, char* argv[]) {
     setvbuf(stdout, NULL, _IONBF, 0);
     srand(time(NULL));
+    initBitboards();
+    initEvaluation();
+    
+    // Endgame tablebases written by tbgen, if there are any
+    int tablebases = initTablebases(TB_DEFAULT_PATH);
+    if (tablebases > 0) {
+        printf("Loaded %d tablebases from %s/\n", tablebases, TB_DEFAULT_PATH);
+    }
+    
+    // An optional network file makes the bot start on the network evaluator
+    if (argc > 1) {
+        if (loadNnue(argv[1])) {
+            setEvaluator(EVALUATOR_NNUE);
+            printf("Loaded network %s (%s inference)\n", argv[1], nnueSimdName());
+        } else {
+            printf("Could not load network %s, using classic evaluation\n", argv[1]);
+        }
+    }
     
     char board[8][8];
     GameState state;
@@ -364,6 +397,10 @@ int main() {
                     displayTime(&timeControl);
                     continue;
                 }
+                if (strcmp(input, "eval") == 0) {
+                    toggleEvaluator();
+                    continue;
+                }
                 if (strcmp(input, "next") != 0) {
                     printf("Invalid command. Use 'next' to proceed or 'quit' to exit.\n");
                     continue;
@@ -387,19 +424,20 @@ int main() {
                 thinkTime = botSettings.defaultThinkTime;
             }
             
-            selectBotMove(board, whiteToMove, &startRow, &startCol, &endRow, &endCol, 
-                         &state, thinkTime, currentEval);
+            Move botMove = selectBotMove(board, whiteToMove, &state, thinkTime, currentEval);
             
-            if (startRow == -1) {
+            if (botMove == MOVE_NONE) {
                 printf("No legal moves for bot. Game over?\n");
                 break;
             }
+            moveToCoordinates(botMove, &startRow, &startCol, &endRow, &endCol);
             
             printf("Bot moves %c%d%c%d\n", 
                    'a' + startCol, 8 - startRow, 
                    'a' + endCol, 8 - endRow);
             
-            executeMove(board, &state, startRow, startCol, endRow, endCol, 1);
+            executeMove(board, &state, startRow, startCol, endRow, endCol, 1, 
+                       movePromotionPiece(botMove));
             
             // End timing and update time remaining
             endMoveTimer(&timeControl, whiteToMove, moveStart);
@@ -427,6 +465,10 @@ int main() {
                 displayTime(&timeControl);
                 continue;
             }
+            if (strcmp(input, "eval") == 0) {
+                toggleEvaluator();
+                continue;
+            }
             if (handleModeChange(input, &gameMode)) continue;
             
             if (!parseMove(input, &startRow, &startCol, &endRow, &endCol)) {
@@ -439,7 +481,7 @@ int main() {
                 continue;
             }
             
-            executeMove(board, &state, startRow, startCol, endRow, endCol, 0);
+            executeMove(board, &state, startRow, startCol, endRow, endCol, 0, 0);
             
             lastStartRow = startRow;
             lastStartCol = startCol;
@@ -28,43 +28,17 @@ static int isNotCapturingSameColor(char board[8][8], int row, int col, int white
     }
 }
 
-static int isPathClear(char board[8][8], int startRow, int startCol, int endRow, int endCol, 
-                       int rowStep, int colStep) {
-    int currentRow = startRow + rowStep;
-    int currentCol = startCol + colStep;
-    
-    while (currentRow != endRow || currentCol != endCol) {
-        if (!isEmpty(board[currentRow][currentCol])) {
+// Every square strictly between start and end must be empty
+static int isPathClear(char board[8][8], Bitboard path) {
+    while (path) {
+        int sq = popLsb(&path);
+        if (!isEmpty(board[SQUARE_ROW(sq)][SQUARE_COL(sq)])) {
             return 0;  // Path blocked
         }
-        currentRow += rowStep;
-        currentCol += colStep;
     }
     return 1;  // Path clear
 }
 
-// ============================================================================
-// MOVE GENERATION OFFSETS
-// ============================================================================
-
-static const int knightOffsets[8][2] = {
-    {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2},
-    {1, -2}, {1, 2}, {2, -1}, {2, 1}
-};
-
-static const int bishopOffsets[4][2] = {
-    {-1, -1}, {-1, 1}, {1, -1}, {1, 1}
-};
-
-static const int rookOffsets[4][2] = {
-    {-1, 0}, {1, 0}, {0, -1}, {0, 1}
-};
-
-static const int queenKingOffsets[8][2] = {
-    {-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
-    {0, 1}, {1, -1}, {1, 0}, {1, 1}
-};
-
 // ============================================================================
 // PROMOTION HELPER FUNCTION
 // ============================================================================
@@ -100,65 +74,6 @@ int isLegalMoveWithPromotion(char board[8][8], int startRow, int startCol, int e
     return 1;
 }
 
-// ============================================================================
-// CASTLING MOVE GENERATION
-// ============================================================================
-
-// ============================================================================
-// CORRECTED CASTLING MOVE GENERATION
-// ============================================================================
-
-static int generateCastlingMoves(char board[8][8], int row, int col, Move moves[], int count, int whiteToMove, GameState* state) {
-    // Only kings can castle
-    if (toupper(board[row][col]) != 'K') return count;
-    
-    int isWhite = isWhitePiece(board[row][col]);
-    
-    // Kingside castling
-    if ((isWhite && state->whiteKingsideCastle) || (!isWhite && state->blackKingsideCastle)) {
-        int rookCol = 7; // h-file
-        int kingTargetCol = col + 2;
-        int rookTargetCol = col + 1;
-        
-        // Check if path is clear
-        if (isEmpty(board[row][col+1]) && isEmpty(board[row][col+2])) {
-            // Check if rook is in correct position
-            char expectedRook = isWhite ? 'R' : 'r';
-            if (board[row][rookCol] == expectedRook) {
-                // Check if squares are not attacked
-                if (!isSquareAttacked(board, row, col, !whiteToMove, state) &&
-                    !isSquareAttacked(board, row, col+1, !whiteToMove, state) &&
-                    !isSquareAttacked(board, row, col+2, !whiteToMove, state)) {
-                    moves[count++] = (Move){row, col, row, kingTargetCol, 0};
-                }
-            }
-        }
-    }
-    
-    // Queenside castling
-    if ((isWhite && state->whiteQueensideCastle) || (!isWhite && state->blackQueensideCastle)) {
-        int rookCol = 0; // a-file
-        int kingTargetCol = col - 2;
-        int rookTargetCol = col - 1;
-        
-        // Check if path is clear (queenside has 3 squares between rook and king)
-        if (isEmpty(board[row][col-1]) && isEmpty(board[row][col-2]) && isEmpty(board[row][col-3])) {
-            // Check if rook is in correct position
-            char expectedRook = isWhite ? 'R' : 'r';
-            if (board[row][rookCol] == expectedRook) {
-                // Check if squares are not attacked (don't need to check b1/b8 for white/black)
-                if (!isSquareAttacked(board, row, col, !whiteToMove, state) &&
-                    !isSquareAttacked(board, row, col-1, !whiteToMove, state) &&
-                    !isSquareAttacked(board, row, col-2, !whiteToMove, state)) {
-                    moves[count++] = (Move){row, col, row, kingTargetCol, 0};
-                }
-            }
-        }
-    }
-    
-    return count;
-}
-
 // ============================================================================
 // PIECE MOVEMENT RULES (KEEP ORIGINAL SIGNATURES)
 // ============================================================================
@@ -214,36 +129,33 @@ int isValidKnightMove(int startRow, int startCol, int endRow, int endCol) {
 }
 
 int isValidBishopMove(char board[8][8], int startRow, int startCol, int endRow, int endCol) {
-    int rowDiff = abs(endRow - startRow);
-    int colDiff = abs(endCol - startCol);
+    int from = SQUARE(startRow, startCol);
+    int to = SQUARE(endRow, endCol);
     
     // Must move diagonally
-    if (rowDiff != colDiff || rowDiff == 0) return 0;
-    
-    int rowStep = (endRow > startRow) ? 1 : -1;
-    int colStep = (endCol > startCol) ? 1 : -1;
+    if (!(bishopAttacks(from, 0) & SQUARE_BB(to))) return 0;
     
-    return isPathClear(board, startRow, startCol, endRow, endCol, rowStep, colStep);
+    return isPathClear(board, betweenBB[from][to]);
 }
 
 int isValidRookMove(char board[8][8], int startRow, int startCol, int endRow, int endCol) {
-    int rowDiff = abs(endRow - startRow);
-    int colDiff = abs(endCol - startCol);
+    int from = SQUARE(startRow, startCol);
+    int to = SQUARE(endRow, endCol);
     
     // Must move straight (horizontal or vertical)
-    int isHorizontal = (rowDiff == 0 && colDiff > 0);
-    int isVertical = (colDiff == 0 && rowDiff > 0);
-    if (!isHorizontal && !isVertical) return 0;
-    
-    int rowStep = (rowDiff == 0) ? 0 : (endRow > startRow ? 1 : -1);
-    int colStep = (colDiff == 0) ? 0 : (endCol > startCol ? 1 : -1);
+    if (!(rookAttacks(from, 0) & SQUARE_BB(to))) return 0;
     
-    return isPathClear(board, startRow, startCol, endRow, endCol, rowStep, colStep);
+    return isPathClear(board, betweenBB[from][to]);
 }
 
 int isValidQueenMove(char board[8][8], int startRow, int startCol, int endRow, int endCol) {
-    return isValidBishopMove(board, startRow, startCol, endRow, endCol) ||
-           isValidRookMove(board, startRow, startCol, endRow, endCol);
+    int from = SQUARE(startRow, startCol);
+    int to = SQUARE(endRow, endCol);
+    
+    // Must share a rank, file or diagonal
+    if (from == to || !lineBB[from][to]) return 0;
+    
+    return isPathClear(board, betweenBB[from][to]);
 }
 
 int isValidKingMove(char board[8][8], int startRow, int startCol, int endRow, int endCol, 
@@ -309,174 +221,6 @@ int isValidKingMove(char board[8][8], int startRow, int startCol, int endRow, in
     return 0;
 }
 
-// ============================================================================
-// IMPROVED PAWN MOVE GENERATION WITH PROMOTION
-// ============================================================================
-
-static int generatePawnMoves(char board[8][8], int row, int col, Move moves[], int count, int whiteToMove, GameState* state) {
-    char piece = board[row][col];
-    int isWhite = isWhitePiece(piece);
-    int direction = isWhite ? -1 : 1;
-    int startRank = isWhite ? 6 : 1;
-    int promotionRank = isWhite ? 0 : 7;
-    
-    // Single forward move
-    int newRow = row + direction;
-    if (newRow >= 0 && newRow < 8 && isEmpty(board[newRow][col])) {
-        if (newRow == promotionRank) {
-            // Generate all promotion options
-            char promotionPieces[] = {'Q', 'R', 'B', 'N'};
-            for (int i = 0; i < 4; i++) {
-                if (isLegalMoveWithPromotion(board, row, col, newRow, col, whiteToMove, state, promotionPieces[i])) {
-                    moves[count++] = (Move){row, col, newRow, col, promotionPieces[i]};
-                }
-            }
-        } else {
-            if (isLegalMove(board, row, col, newRow, col, whiteToMove, state)) {
-                moves[count++] = (Move){row, col, newRow, col, 0};
-            }
-        }
-        
-        // Double forward move from starting position
-        if (row == startRank) {
-            int doubleRow = row + 2 * direction;
-            if (doubleRow >= 0 && doubleRow < 8 && isEmpty(board[doubleRow][col]) && 
-                isLegalMove(board, row, col, doubleRow, col, whiteToMove, state)) {
-                moves[count++] = (Move){row, col, doubleRow, col, 0};
-            }
-        }
-    }
-    
-    // Diagonal captures (including en passant)
-    int captureCols[] = {col - 1, col + 1};
-    for (int i = 0; i < 2; i++) {
-        int newCol = captureCols[i];
-        if (newCol < 0 || newCol >= 8) continue;
-        
-        int newRow = row + direction;
-        if (newRow < 0 || newRow >= 8) continue;
-        
-        // Check if this is a legal capture (normal or en passant)
-        if (isLegalMove(board, row, col, newRow, newCol, whiteToMove, state)) {
-            if (newRow == promotionRank) {
-                // Generate all promotion options for captures
-                char promotionPieces[] = {'Q', 'R', 'B', 'N'};
-                for (int j = 0; j < 4; j++) {
-                    if (isLegalMoveWithPromotion(board, row, col, newRow, newCol, whiteToMove, state, promotionPieces[j])) {
-                        moves[count++] = (Move){row, col, newRow, newCol, promotionPieces[j]};
-                    }
-                }
-            } else {
-                moves[count++] = (Move){row, col, newRow, newCol, 0};
-            }
-        }
-    }
-    return count;
-}
-
-// ============================================================================
-// PIECE-SPECIFIC MOVE GENERATORS
-// ============================================================================
-
-static int generateKnightMoves(char board[8][8], int row, int col, Move moves[], int count, int whiteToMove, GameState* state) {
-    for (int i = 0; i < 8; i++) {
-        int newRow = row + knightOffsets[i][0];
-        int newCol = col + knightOffsets[i][1];
-        
-        // Check bounds
-        if (newRow < 0 || newRow >= 8 || newCol < 0 || newCol >= 8) continue;
-        
-        // Check if move is legal using your existing function
-        if (isLegalMove(board, row, col, newRow, newCol, whiteToMove, state)) {
-            moves[count].startRow = row;
-            moves[count].startCol = col;
-            moves[count].endRow = newRow;
-            moves[count].endCol = newCol;
-            moves[count].promotionPiece = 0;
-            count++;
-        }
-    }
-    return count;
-}
-
-static int generateBishopMoves(char board[8][8], int row, int col, Move moves[], int count, int whiteToMove, GameState* state) {
-    for (int i = 0; i < 4; i++) {
-        int rowStep = bishopOffsets[i][0];
-        int colStep = bishopOffsets[i][1];
-        int newRow = row + rowStep;
-        int newCol = col + colStep;
-        
-        // Slide in this direction until we hit the board edge or a piece
-        while (newRow >= 0 && newRow < 8 && newCol >= 0 && newCol < 8) {
-            // Check if move is legal
-            if (isLegalMove(board, row, col, newRow, newCol, whiteToMove, state)) {
-                moves[count++] = (Move){row, col, newRow, newCol, 0};
-            }
-            
-            // Stop if we hit a piece (we already included the capture in the check above)
-            if (!isEmpty(board[newRow][newCol])) {
-                break;
-            }
-            
-            newRow += rowStep;
-            newCol += colStep;
-        }
-    }
-    return count;
-}
-
-static int generateRookMoves(char board[8][8], int row, int col, Move moves[], int count, int whiteToMove, GameState* state) {
-    for (int i = 0; i < 4; i++) {
-        int rowStep = rookOffsets[i][0];
-        int colStep = rookOffsets[i][1];
-        int newRow = row + rowStep;
-        int newCol = col + colStep;
-        
-        // Slide in this direction until we hit the board edge or a piece
-        while (newRow >= 0 && newRow < 8 && newCol >= 0 && newCol < 8) {
-            // Check if move is legal
-            if (isLegalMove(board, row, col, newRow, newCol, whiteToMove, state)) {
-                moves[count++] = (Move){row, col, newRow, newCol, 0};
-            }
-            
-            // Stop if we hit a piece
-            if (!isEmpty(board[newRow][newCol])) {
-                break;
-            }
-            
-            newRow += rowStep;
-            newCol += colStep;
-        }
-    }
-    return count;
-}
-
-static int generateQueenMoves(char board[8][8], int row, int col, Move moves[], int count, int whiteToMove, GameState* state) {
-    // Queen moves like bishop + rook
-    count = generateBishopMoves(board, row, col, moves, count, whiteToMove, state);
-    count = generateRookMoves(board, row, col, moves, count, whiteToMove, state);
-    return count;
-}
-
-static int generateKingMoves(char board[8][8], int row, int col, Move moves[], int count, int whiteToMove, GameState* state) {
-    // Normal king moves (one square in any direction)
-    for (int i = 0; i < 8; i++) {
-        int newRow = row + queenKingOffsets[i][0];
-        int newCol = col + queenKingOffsets[i][1];
-        
-        if (newRow < 0 || newRow >= 8 || newCol < 0 || newCol >= 8) continue;
-        
-        if (isLegalMove(board, row, col, newRow, newCol, whiteToMove, state)) {
-            moves[count++] = (Move){row, col, newRow, newCol, 0};
-        }
-    }
-    
-    // Add castling moves
-    count = generateCastlingMoves(board, row, col, moves, count, whiteToMove, state);
-    
-    return count;
-}
-
 // ============================================================================
 // MAIN MOVE VALIDATION (KEEP ORIGINAL)
 // ============================================================================
@@ -514,42 +258,296 @@ int isLegalMove(char board[8][8], int startRow, int startCol, int endRow, int en
 }
 
 // ============================================================================
-// IMPROVED MOVE GENERATION FUNCTION
+// BITBOARD MOVE GENERATION
 // ============================================================================
 
-int generateAllLegalMoves(char board[8][8], int whiteToMove, Move moves[], GameState* state) {
-    int count = 0;
+// Checkers and pinned pieces are computed once per node; every non-king move is
+// then restricted to the check-block mask and, if pinned, to its pin ray.
+// Only king moves and en passant need an explicit attack test.
+
+// Make the move on the bitboards, test the mover's king, and put everything back
+static int leavesKingInCheck(Position* pos, int from, int to, int capturedSquare, int whiteToMove) {
+    char captured = pos->board[SQUARE_ROW(capturedSquare)][SQUARE_COL(capturedSquare)];
+    removePiece(pos, capturedSquare);
+    movePiece(pos, from, to);
+    
+    int inCheck = isInCheck(pos, whiteToMove);
+    
+    movePiece(pos, to, from);
+    putPiece(pos, capturedSquare, captured);
+    return inCheck;
+}
+
+// Own pieces that are the only blocker between the king and an enemy slider
+static Bitboard pinnedPieces(Position* pos, int kingSquare, int color) {
+    int enemy = !color;
+    Bitboard queens = pos->pieces[PIECE_INDEX(enemy, QUEEN)];
+    Bitboard snipers = (rookAttacks(kingSquare, 0) & (pos->pieces[PIECE_INDEX(enemy, ROOK)] | queens)) |
+                       (bishopAttacks(kingSquare, 0) & (pos->pieces[PIECE_INDEX(enemy, BISHOP)] | queens));
+    Bitboard pinned = 0;
+    
+    while (snipers) {
+        int sniper = popLsb(&snipers);
+        Bitboard blockers = betweenBB[kingSquare][sniper] & pos->occupied;
+        if (blockers && !(blockers & (blockers - 1)) && (blockers & pos->colors[color])) {
+            pinned |= blockers;
+        }
+    }
+    return pinned;
+}
+
+static void addMove(MoveList* list, int from, int to, int flags) {
+    list->moves[list->count++] = ENCODE_MOVE(from, to, flags);
+}
+
+static void addMoves(MoveList* list, int from, Bitboard targets) {
+    while (targets) {
+        addMove(list, from, popLsb(&targets), MOVE_NORMAL);
+    }
+}
+
+static void addPawnMove(MoveList* list, int from, int to, int promotionRank) {
+    if (SQUARE_ROW(to) != promotionRank) {
+        addMove(list, from, to, MOVE_NORMAL);
+        return;
+    }
+    // Queen first, then rook, bishop, knight
+    for (int type = QUEEN; type >= KNIGHT; type--) {
+        addMove(list, from, to, MOVE_PROMOTION | (type - KNIGHT));
+    }
+}
+
+static void generatePawnMoves(Position* pos, int from, MoveList* list, int whiteToMove, 
+                              Bitboard allowed, int genType) {
+    int color = whiteToMove ? COLOR_WHITE : COLOR_BLACK;
+    int forward = whiteToMove ? -8 : 8;
+    int startRank = whiteToMove ? 6 : 1;
+    int promotionRank = whiteToMove ? 0 : 7;
+    int row = SQUARE_ROW(from);
+    
+    // Forward pushes; a push that promotes belongs with the captures
+    int to = from + forward;
+    if (!(pos->occupied & SQUARE_BB(to))) {
+        int pushKind = (SQUARE_ROW(to) == promotionRank) ? GEN_CAPTURES : GEN_QUIETS;
+        if ((genType & pushKind) && (allowed & SQUARE_BB(to))) {
+            addPawnMove(list, from, to, promotionRank);
+        }
+        int doubleTo = to + forward;
+        if ((genType & GEN_QUIETS) && row == startRank && 
+            !(pos->occupied & SQUARE_BB(doubleTo)) && (allowed & SQUARE_BB(doubleTo))) {
+            addMove(list, from, doubleTo, MOVE_DOUBLE_PUSH);
+        }
+    }
+    
+    if (!(genType & GEN_CAPTURES)) return;
+    
+    // Diagonal captures
+    Bitboard captures = pawnAttacks[color][from] & pos->colors[!color] & allowed;
+    while (captures) {
+        addPawnMove(list, from, popLsb(&captures), promotionRank);
+    }
+    
+    // En passant removes two pieces from the capture rank, so it is tested directly
+    if (pos->epSquare != NO_SQUARE) {
+        int epSquare = pos->epSquare;
+        if (pawnAttacks[color][from] & SQUARE_BB(epSquare)) {
+            int capturedSquare = SQUARE(row, SQUARE_COL(epSquare));
+            if (!leavesKingInCheck(pos, from, epSquare, capturedSquare, whiteToMove)) {
+                addMove(list, from, epSquare, MOVE_EN_PASSANT);
+            }
+        }
+    }
+}
+
+static void generateKnightMoves(int from, MoveList* list, Bitboard targets) {
+    addMoves(list, from, knightAttacks[from] & targets);
+}
+
+static void generateBishopMoves(Position* pos, int from, MoveList* list, Bitboard targets) {
+    addMoves(list, from, bishopAttacks(from, pos->occupied) & targets);
+}
+
+static void generateRookMoves(Position* pos, int from, MoveList* list, Bitboard targets) {
+    addMoves(list, from, rookAttacks(from, pos->occupied) & targets);
+}
+
+static void generateQueenMoves(Position* pos, int from, MoveList* list, Bitboard targets) {
+    addMoves(list, from, queenAttacks(from, pos->occupied) & targets);
+}
+
+static void generateCastlingMoves(Position* pos, int from, MoveList* list, int whiteToMove) {
+    int row = whiteToMove ? 7 : 0;
+    char expectedRook = whiteToMove ? 'R' : 'r';
+    int kingside = pos->castling & (whiteToMove ? CASTLE_WHITE_KINGSIDE : CASTLE_BLACK_KINGSIDE);
+    int queenside = pos->castling & (whiteToMove ? CASTLE_WHITE_QUEENSIDE : CASTLE_BLACK_QUEENSIDE);
+    
+    if (from != SQUARE(row, 4)) return;
+    
+    // Kingside: f and g empty, king not passing through or landing on an attacked square
+    if (kingside && pos->board[row][7] == expectedRook &&
+        !(pos->occupied & betweenBB[from][SQUARE(row, 7)])) {
+        if (!isAttacked(pos, from + 1, !whiteToMove) &&
+            !isAttacked(pos, from + 2, !whiteToMove)) {
+            addMove(list, from, from + 2, MOVE_CASTLE);
+        }
+    }
+    
+    // Queenside: b, c and d empty (b may be attacked)
+    if (queenside && pos->board[row][0] == expectedRook &&
+        !(pos->occupied & betweenBB[from][SQUARE(row, 0)])) {
+        if (!isAttacked(pos, from - 1, !whiteToMove) &&
+            !isAttacked(pos, from - 2, !whiteToMove)) {
+            addMove(list, from, from - 2, MOVE_CASTLE);
+        }
+    }
+}
+
+static void generateKingMoves(Position* pos, int from, MoveList* list, int whiteToMove, 
+                              Bitboard checkers, Bitboard genTargets, int genType,
+                              const AttackMaps* maps) {
+    int color = whiteToMove ? COLOR_WHITE : COLOR_BLACK;
+    Bitboard targets = kingAttacks[from] & genTargets;
+    
+    // No slider looks through an unchecked king, so the enemy map is exact
+    if (maps && !checkers) {
+        addMoves(list, from, targets & ~maps->bySide[!color]);
+        if (genType & GEN_QUIETS) {
+            generateCastlingMoves(pos, from, list, whiteToMove);
+        }
+        return;
+    }
+    
+    // Remove the king from the occupancy so sliders see through it
+    Bitboard occupied = pos->occupied ^ SQUARE_BB(from);
+    while (targets) {
+        int to = popLsb(&targets);
+        if (!(attackersTo(pos, to, occupied) & pos->colors[!color])) {
+            addMove(list, from, to, MOVE_NORMAL);
+        }
+    }
     
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            char piece = board[row][col];
+    // Castling is only possible when not in check
+    if (!checkers && (genType & GEN_QUIETS)) {
+        generateCastlingMoves(pos, from, list, whiteToMove);
+    }
+}
+
+// Moves of the requested kinds for the side's pieces standing on fromMask
+static int generateMovesFrom(Position* pos, int whiteToMove, MoveList* list, 
+                             int genType, Bitboard fromMask, const AttackMaps* maps) {
+    int color = whiteToMove ? COLOR_WHITE : COLOR_BLACK;
+    int kingSquare = pos->kingSquare[color];
+    
+    list->count = 0;
+    if (kingSquare == NO_SQUARE) return 0;  // King not found (shouldn't happen)
+    
+    // Destination squares for each kind: enemy pieces and/or empty squares
+    Bitboard genTargets = 0;
+    if (genType & GEN_CAPTURES) genTargets |= pos->colors[!color];
+    if (genType & GEN_QUIETS) genTargets |= ~pos->occupied;
+    
+    Bitboard checkers = attackersTo(pos, kingSquare, pos->occupied) & pos->colors[!color];
+    if (fromMask & SQUARE_BB(kingSquare)) {
+        generateKingMoves(pos, kingSquare, list, whiteToMove, checkers, genTargets, genType, maps);
+    }
+    
+    // In double check only the king can move
+    if (checkers & (checkers - 1)) return list->count;
+    
+    // Non-king moves must capture the checker or block its ray
+    Bitboard checkMask = ~0ULL;
+    if (checkers) {
+        checkMask = checkers | betweenBB[kingSquare][lsbIndex(checkers)];
+    }
+    Bitboard pinned = pinnedPieces(pos, kingSquare, color);
+    
+    // Walk the piece lists so only pieces that exist are visited
+    for (int type = PAWN; type < KING; type++) {
+        int idx = PIECE_INDEX(color, type);
+        for (int i = 0; i < pos->pieceCount[idx]; i++) {
+            int from = pos->pieceList[idx][i];
+            if (!(fromMask & SQUARE_BB(from))) continue;
             
-            // Skip empty squares and pieces of wrong color
-            if (isEmpty(piece)) continue;
-            if (!isCorrectColorMoving(board, row, col, whiteToMove)) continue;
+            Bitboard allowed = checkMask;
+            if (pinned & SQUARE_BB(from)) {
+                allowed &= lineBB[kingSquare][from];
+            }
+            Bitboard targets = genTargets & allowed;
             
-            // Generate moves based on piece type
-            switch (toupper(piece)) {
-                case 'P': 
-                    count = generatePawnMoves(board, row, col, moves, count, whiteToMove, state);
-                    break;
-                case 'N':
-                    count = generateKnightMoves(board, row, col, moves, count, whiteToMove, state);
+            switch (type) {
+                case PAWN:
+                    generatePawnMoves(pos, from, list, whiteToMove, allowed, genType);
                     break;
-                case 'B':
-                    count = generateBishopMoves(board, row, col, moves, count, whiteToMove, state);
+                case KNIGHT:
+                    generateKnightMoves(from, list, targets);
                     break;
-                case 'R':
-                    count = generateRookMoves(board, row, col, moves, count, whiteToMove, state);
+                case BISHOP:
+                    generateBishopMoves(pos, from, list, targets);
                     break;
-                case 'Q':
-                    count = generateQueenMoves(board, row, col, moves, count, whiteToMove, state);
+                case ROOK:
+                    generateRookMoves(pos, from, list, targets);
                     break;
-                case 'K':
-                    count = generateKingMoves(board, row, col, moves, count, whiteToMove, state);
+                case QUEEN:
+                    generateQueenMoves(pos, from, list, targets);
                     break;
             }
         }
     }
-    return count;
-}
\ No newline at end of file
+    return list->count;
+}
+
+int generateMoves(Position* pos, int whiteToMove, MoveList* list, int genType) {
+    return generateMovesFrom(pos, whiteToMove, list, genType, ~0ULL, NULL);
+}
+
+int generateMovesWithAttacks(Position* pos, int whiteToMove, MoveList* list, int genType,
+                             const AttackMaps* maps) {
+    return generateMovesFrom(pos, whiteToMove, list, genType, ~0ULL, maps);
+}
+
+int generateLegalMoves(Position* pos, int whiteToMove, MoveList* list) {
+    return generateMovesFrom(pos, whiteToMove, list, GEN_ALL, ~0ULL, NULL);
+}
+
+// Check a move from the TT or the killer table without generating every move:
+// only the moves of the piece on its start square are produced
+int isLegalMoveInPosition(Position* pos, int whiteToMove, Move move) {
+    int from = MOVE_FROM(move);
+    int color = whiteToMove ? COLOR_WHITE : COLOR_BLACK;
+    if (move == MOVE_NONE || !(pos->colors[color] & SQUARE_BB(from))) return 0;
+    
+    MoveList list;
+    generateMovesFrom(pos, whiteToMove, &list, GEN_ALL, SQUARE_BB(from), NULL);
+    for (int i = 0; i < list.count; i++) {
+        if (SAME_MOVE(list.moves[i], move)) return 1;
+    }
+    return 0;
+}
+
+int generateAllLegalMoves(char board[8][8], int whiteToMove, Move moves[], GameState* state) {
+    Position pos;
+    MoveList list;
+    positionFromBoard(&pos, board, state);
+    generateLegalMoves(&pos, whiteToMove, &list);
+    for (int i = 0; i < list.count; i++) {
+        moves[i] = list.moves[i];
+    }
+    return list.count;
+}
+
+// ============================================================================
+// MOVE CONVERSION FOR THE UI
+// ============================================================================
+
+void moveToCoordinates(Move move, int* startRow, int* startCol, int* endRow, int* endCol) {
+    *startRow = SQUARE_ROW(MOVE_FROM(move));
+    *startCol = SQUARE_COL(MOVE_FROM(move));
+    *endRow = SQUARE_ROW(MOVE_TO(move));
+    *endCol = SQUARE_COL(MOVE_TO(move));
+}
+
+char movePromotionPiece(Move move) {
+    if (!IS_PROMOTION(move)) return 0;
+    return "NBRQ"[PROMOTION_TYPE(move) - KNIGHT];
+}
+
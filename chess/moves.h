@@ -2,15 +2,39 @@
 #define MOVES_H
 
 #include <gameState.h>
+#include <position.h>
+
+#define MAX_MOVES 256
+
+// Packed 16-bit move for bot move generation:
+// bits 0-5 start square, bits 6-11 end square, bits 12-15 flags
+typedef unsigned short Move;
+
+#define MOVE_NONE 0           // a8a8, never a legal move
+#define MOVE_NORMAL 0
+#define MOVE_DOUBLE_PUSH 1
+#define MOVE_CASTLE 2
+#define MOVE_EN_PASSANT 3
+#define MOVE_PROMOTION 8      // Plus 0-3 for N, B, R, Q
+
+#define ENCODE_MOVE(from, to, flags) ((Move)((from) | ((to) << 6) | ((flags) << 12)))
+#define MOVE_FROM(m) ((m) & 0x3F)
+#define MOVE_TO(m) (((m) >> 6) & 0x3F)
+#define MOVE_FLAGS(m) ((m) >> 12)
+#define IS_PROMOTION(m) (MOVE_FLAGS(m) & MOVE_PROMOTION)
+#define PROMOTION_TYPE(m) (KNIGHT + (MOVE_FLAGS(m) & 3))
+
+// Moves are equal exactly when their packed values are
+#define SAME_MOVE(a, b) ((a) == (b))
 
-// Move structure for bot move generation
 typedef struct {
-    int startRow;
-    int startCol;
-    int endRow;
-    int endCol;
-    char promotionPiece;  // ADD THIS: 'Q', 'R', 'B', 'N', or 0 for none
-} Move;
+    Move moves[MAX_MOVES];
+    int count;
+} MoveList;
+
+// Conversion between packed moves and the UI's row/col coordinates
+void moveToCoordinates(Move move, int* startRow, int* startCol, int* endRow, int* endCol);
+char movePromotionPiece(Move move);  // 'Q', 'R', 'B', 'N', or 0 for none
 
 // Core move validation
 int isLegalMove(char board[8][8], int startRow, int startCol, int endRow, int endCol, 
@@ -33,6 +57,25 @@ int isValidKingMove(char board[8][8], int startRow, int startCol, int endRow, in
 // Move generation for bot
 int generateAllLegalMoves(char board[8][8], int whiteToMove, Move moves[], GameState* state);
 
+// Bitboard move generation used by the search (same move set as above)
+int generateLegalMoves(Position* pos, int whiteToMove, MoveList* list);
+
+// Kinds of moves for staged generation. Captures include en passant and
+// every promotion; quiets are the remaining pushes, piece moves and castling.
+#define GEN_CAPTURES 1
+#define GEN_QUIETS 2
+#define GEN_ALL (GEN_CAPTURES | GEN_QUIETS)
+
+int generateMoves(Position* pos, int whiteToMove, MoveList* list, int genType);
+
+// Same, with the attack maps of this exact position (NULL if there are none):
+// out of check, king moves are then filtered by the enemy map alone
+int generateMovesWithAttacks(Position* pos, int whiteToMove, MoveList* list, int genType,
+                             const AttackMaps* maps);
+
+// Full legality test for a single packed move (hash and killer moves)
+int isLegalMoveInPosition(Position* pos, int whiteToMove, Move move);
+
 // ADD THIS: Promotion validation helper
 int isLegalMoveWithPromotion(char board[8][8], int startRow, int startCol, int endRow, int endCol, 
                             int whiteToMove, GameState* state, char promotionPiece);
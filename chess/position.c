@@ -0,0 +1,258 @@
+#include <string.h>
+#include <stddef.h>
+#include <position.h>
+#include <board.h>
+
+static const char pieceChars[NUM_PIECE_TYPES + 1] = "PNBRQKpnbrqk";
+
+unsigned long long zobristPieces[NUM_PIECE_TYPES][NUM_SQUARES];
+unsigned long long zobristCastling[16];
+unsigned long long zobristEnPassant[8];
+unsigned long long zobristSide;
+
+static int zobristInitialized = 0;
+
+int pieceSquareMg[NUM_PIECE_TYPES][NUM_SQUARES];
+int pieceSquareEg[NUM_PIECE_TYPES][NUM_SQUARES];
+int piecePhase[NUM_PIECE_TYPES];
+
+// Char to piece index plus one, so the zero default marks a non-piece.
+// Constant so threads can share it without any setup.
+static const signed char pieceIndexTable[256] = {
+    ['P'] = 1, ['N'] = 2, ['B'] = 3, ['R'] = 4, ['Q'] = 5, ['K'] = 6,
+    ['p'] = 7, ['n'] = 8, ['b'] = 9, ['r'] = 10, ['q'] = 11, ['k'] = 12,
+};
+
+int pieceIndex(char piece) {
+    return pieceIndexTable[(unsigned char)piece] - 1;
+}
+
+char indexToPiece(int index) {
+    if (index < 0 || index >= NUM_PIECE_TYPES) return '.';
+    return pieceChars[index];
+}
+
+// ============================================================================
+// ZOBRIST KEYS
+// ============================================================================
+
+// splitmix64 with a fixed seed: every bit of every key is random and the keys
+// are the same on every run
+static unsigned long long zobristSeed = 0x2545F4914F6CDD1DULL;
+
+static unsigned long long nextZobristKey(void) {
+    unsigned long long z = (zobristSeed += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void initZobrist(void) {
+    if (zobristInitialized) return;
+
+    for (int piece = 0; piece < NUM_PIECE_TYPES; piece++) {
+        for (int sq = 0; sq < NUM_SQUARES; sq++) {
+            zobristPieces[piece][sq] = nextZobristKey();
+        }
+    }
+    // Castling keys combine per-right keys so each right toggles independently
+    unsigned long long rightKeys[4];
+    for (int i = 0; i < 4; i++) rightKeys[i] = nextZobristKey();
+    for (int mask = 0; mask < 16; mask++) {
+        zobristCastling[mask] = 0;
+        for (int i = 0; i < 4; i++) {
+            if (mask & (1 << i)) zobristCastling[mask] ^= rightKeys[i];
+        }
+    }
+    for (int col = 0; col < 8; col++) {
+        zobristEnPassant[col] = nextZobristKey();
+    }
+    zobristSide = nextZobristKey();
+    zobristInitialized = 1;
+}
+
+int castlingIndex(GameState* state) {
+    return (state->whiteKingsideCastle ? CASTLE_WHITE_KINGSIDE : 0) | 
+           (state->whiteQueensideCastle ? CASTLE_WHITE_QUEENSIDE : 0) |
+           (state->blackKingsideCastle ? CASTLE_BLACK_KINGSIDE : 0) | 
+           (state->blackQueensideCastle ? CASTLE_BLACK_QUEENSIDE : 0);
+}
+
+unsigned long long materialKeyOf(const int counts[NUM_PIECE_TYPES]) {
+    unsigned long long key = 0;
+    for (int idx = 0; idx < NUM_PIECE_TYPES; idx++) {
+        for (int n = 0; n < counts[idx]; n++) key ^= zobristPieces[idx][n];
+    }
+    return key;
+}
+
+unsigned long long positionKey(Position* pos, int whiteToMove) {
+    return whiteToMove ? pos->hash : pos->hash ^ zobristSide;
+}
+
+// ============================================================================
+// PIECE PRIMITIVES
+// ============================================================================
+
+void putPiece(Position* pos, int square, char piece) {
+    int idx = pieceIndex(piece);
+    if (idx < 0) return;
+
+    Bitboard bb = SQUARE_BB(square);
+    pos->pieces[idx] |= bb;
+    pos->colors[idx < 6 ? COLOR_WHITE : COLOR_BLACK] |= bb;
+    pos->occupied |= bb;
+    pos->board[SQUARE_ROW(square)][SQUARE_COL(square)] = piece;
+    pos->hash ^= zobristPieces[idx][square];
+    if (idx % 6 == PAWN) pos->pawnHash ^= zobristPieces[idx][square];
+    pos->mgScore += pieceSquareMg[idx][square];
+    pos->egScore += pieceSquareEg[idx][square];
+    pos->phase += piecePhase[idx];
+    // The material key holds zobristPieces[idx][n] for each n below the count
+    pos->materialKey ^= zobristPieces[idx][pos->pieceCount[idx]];
+
+    pos->listSlot[square] = pos->pieceCount[idx];
+    pos->pieceList[idx][pos->pieceCount[idx]++] = square;
+    if (idx % 6 == KING) pos->kingSquare[idx / 6] = square;
+}
+
+void removePiece(Position* pos, int square) {
+    char piece = pos->board[SQUARE_ROW(square)][SQUARE_COL(square)];
+    int idx = pieceIndex(piece);
+    if (idx < 0) return;
+
+    Bitboard bb = SQUARE_BB(square);
+    pos->pieces[idx] &= ~bb;
+    pos->colors[idx < 6 ? COLOR_WHITE : COLOR_BLACK] &= ~bb;
+    pos->occupied &= ~bb;
+    pos->board[SQUARE_ROW(square)][SQUARE_COL(square)] = '.';
+    pos->hash ^= zobristPieces[idx][square];
+    if (idx % 6 == PAWN) pos->pawnHash ^= zobristPieces[idx][square];
+    pos->mgScore -= pieceSquareMg[idx][square];
+    pos->egScore -= pieceSquareEg[idx][square];
+    pos->phase -= piecePhase[idx];
+
+    // Fill the hole with the last piece of the list
+    int slot = pos->listSlot[square];
+    int last = pos->pieceList[idx][--pos->pieceCount[idx]];
+    pos->materialKey ^= zobristPieces[idx][pos->pieceCount[idx]];
+    pos->pieceList[idx][slot] = last;
+    pos->listSlot[last] = slot;
+    pos->listSlot[square] = -1;
+    if (idx % 6 == KING) pos->kingSquare[idx / 6] = NO_SQUARE;
+}
+
+// Move a piece to an empty square
+void movePiece(Position* pos, int from, int to) {
+    char piece = pos->board[SQUARE_ROW(from)][SQUARE_COL(from)];
+    int idx = pieceIndex(piece);
+    if (idx < 0) return;
+
+    Bitboard fromTo = SQUARE_BB(from) | SQUARE_BB(to);
+    pos->pieces[idx] ^= fromTo;
+    pos->colors[idx < 6 ? COLOR_WHITE : COLOR_BLACK] ^= fromTo;
+    pos->occupied ^= fromTo;
+    pos->board[SQUARE_ROW(from)][SQUARE_COL(from)] = '.';
+    pos->board[SQUARE_ROW(to)][SQUARE_COL(to)] = piece;
+    pos->hash ^= zobristPieces[idx][from] ^ zobristPieces[idx][to];
+    if (idx % 6 == PAWN) pos->pawnHash ^= zobristPieces[idx][from] ^ zobristPieces[idx][to];
+    pos->mgScore += pieceSquareMg[idx][to] - pieceSquareMg[idx][from];
+    pos->egScore += pieceSquareEg[idx][to] - pieceSquareEg[idx][from];
+
+    int slot = pos->listSlot[from];
+    pos->pieceList[idx][slot] = to;
+    pos->listSlot[to] = slot;
+    pos->listSlot[from] = -1;
+    if (idx % 6 == KING) pos->kingSquare[idx / 6] = to;
+}
+
+void positionFromBoard(Position* pos, char board[8][8], GameState* state) {
+    initZobrist();
+    memset(pos, 0, offsetof(Position, undoStack));  // The undo records need no clearing
+    pos->undoCount = 0;
+    memset(pos->board, '.', sizeof(pos->board));
+    memset(pos->listSlot, -1, sizeof(pos->listSlot));
+    pos->kingSquare[COLOR_WHITE] = NO_SQUARE;
+    pos->kingSquare[COLOR_BLACK] = NO_SQUARE;
+
+    for (int row = 0; row < 8; row++) {
+        for (int col = 0; col < 8; col++) {
+            if (!isEmpty(board[row][col])) {
+                putPiece(pos, SQUARE(row, col), board[row][col]);
+            }
+        }
+    }
+    pos->castling = castlingIndex(state);
+    pos->epSquare = (state->enPassantCol >= 0) ? SQUARE(state->enPassantRow, state->enPassantCol) : NO_SQUARE;
+    pos->hash ^= zobristCastling[pos->castling];
+    if (pos->epSquare != NO_SQUARE) pos->hash ^= zobristEnPassant[SQUARE_COL(pos->epSquare)];
+}
+
+void positionToBoard(Position* pos, char board[8][8]) {
+    memcpy(board, pos->board, sizeof(pos->board));
+}
+
+// Look outward from the square with each piece type's attack pattern
+int isAttacked(Position* pos, int square, int byWhite) {
+    int color = byWhite ? COLOR_WHITE : COLOR_BLACK;
+    Bitboard* p = pos->pieces;
+    Bitboard queens = p[PIECE_INDEX(color, QUEEN)];
+    
+    if (pawnAttacks[!color][square] & p[PIECE_INDEX(color, PAWN)]) return 1;
+    if (knightAttacks[square] & p[PIECE_INDEX(color, KNIGHT)]) return 1;
+    if (kingAttacks[square] & p[PIECE_INDEX(color, KING)]) return 1;
+    if (bishopAttacks(square, pos->occupied) & (p[PIECE_INDEX(color, BISHOP)] | queens)) return 1;
+    if (rookAttacks(square, pos->occupied) & (p[PIECE_INDEX(color, ROOK)] | queens)) return 1;
+    return 0;
+}
+
+int isInCheck(Position* pos, int whiteKing) {
+    int kingSquare = pos->kingSquare[whiteKing ? COLOR_WHITE : COLOR_BLACK];
+    if (kingSquare == NO_SQUARE) return 0;  // King not found (shouldn't happen)
+    return isAttacked(pos, kingSquare, !whiteKing);
+}
+
+Bitboard attackersTo(Position* pos, int square, Bitboard occupied) {
+    Bitboard* p = pos->pieces;
+    Bitboard bishopsQueens = p[PIECE_INDEX(COLOR_WHITE, BISHOP)] | p[PIECE_INDEX(COLOR_BLACK, BISHOP)] |
+                             p[PIECE_INDEX(COLOR_WHITE, QUEEN)] | p[PIECE_INDEX(COLOR_BLACK, QUEEN)];
+    Bitboard rooksQueens = p[PIECE_INDEX(COLOR_WHITE, ROOK)] | p[PIECE_INDEX(COLOR_BLACK, ROOK)] |
+                           p[PIECE_INDEX(COLOR_WHITE, QUEEN)] | p[PIECE_INDEX(COLOR_BLACK, QUEEN)];
+
+    // A pawn attacks the square if a pawn of the other color on the square would attack it back
+    return (pawnAttacks[COLOR_BLACK][square] & p[PIECE_INDEX(COLOR_WHITE, PAWN)]) |
+           (pawnAttacks[COLOR_WHITE][square] & p[PIECE_INDEX(COLOR_BLACK, PAWN)]) |
+           (knightAttacks[square] & (p[PIECE_INDEX(COLOR_WHITE, KNIGHT)] | p[PIECE_INDEX(COLOR_BLACK, KNIGHT)])) |
+           (kingAttacks[square] & (p[PIECE_INDEX(COLOR_WHITE, KING)] | p[PIECE_INDEX(COLOR_BLACK, KING)])) |
+           (bishopAttacks(square, occupied) & bishopsQueens) |
+           (rookAttacks(square, occupied) & rooksQueens);
+}
+
+void computeAttackMaps(Position* pos, AttackMaps* maps) {
+    for (int color = COLOR_WHITE; color <= COLOR_BLACK; color++) {
+        Bitboard side = 0, twice = 0;
+        for (int type = PAWN; type <= KING; type++) {
+            int idx = PIECE_INDEX(color, type);
+            Bitboard all = 0;
+            for (int i = 0; i < pos->pieceCount[idx]; i++) {
+                int sq = pos->pieceList[idx][i];
+                Bitboard attacks;
+                switch (type) {
+                    case PAWN:   attacks = pawnAttacks[color][sq]; break;
+                    case KNIGHT: attacks = knightAttacks[sq]; break;
+                    case BISHOP: attacks = bishopAttacks(sq, pos->occupied); break;
+                    case ROOK:   attacks = rookAttacks(sq, pos->occupied); break;
+                    case QUEEN:  attacks = queenAttacks(sq, pos->occupied); break;
+                    default:     attacks = kingAttacks[sq]; break;
+                }
+                maps->pieceAttacks[idx][i] = attacks;
+                twice |= side & attacks;
+                side |= attacks;
+                all |= attacks;
+            }
+            maps->byPiece[idx] = all;
+        }
+        maps->bySide[color] = side;
+        maps->twice[color] = twice;
+    }
+}
@@ -0,0 +1,123 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <gameState.h>
+#include <bitboard.h>
+
+// Piece indices used by the bitboards and the Zobrist keys: "PNBRQKpnbrqk"
+#define NUM_PIECE_TYPES 12
+#define PIECE_NONE -1
+#define COLOR_WHITE 0
+#define COLOR_BLACK 1
+
+// Piece types; a piece index is color * 6 + type
+#define PAWN 0
+#define KNIGHT 1
+#define BISHOP 2
+#define ROOK 3
+#define QUEEN 4
+#define KING 5
+#define PIECE_INDEX(color, type) ((color) * 6 + (type))
+
+// Two originals plus up to eight promoted pieces
+#define MAX_PIECES_PER_TYPE 10
+
+// Castling rights as bits, also the index into zobristCastling
+#define CASTLE_WHITE_KINGSIDE 1
+#define CASTLE_WHITE_QUEENSIDE 2
+#define CASTLE_BLACK_KINGSIDE 4
+#define CASTLE_BLACK_QUEENSIDE 8
+
+// Deepest line of moves the search can have made at once (main search plus quiescence)
+#define MAX_UNDO 256
+
+// What doMove() overwrites and undoMove() cannot recompute, one record per move made
+typedef struct {
+    unsigned long long hash;  // Key before the move
+    unsigned short move;      // The packed Move (see moves.h)
+    signed char captured;     // Piece index taken, PIECE_NONE if none
+    unsigned char castling;   // Rights before the move
+    signed char epSquare;     // En passant target before the move
+} UndoRecord;
+
+// Bitboard position used by the search. The char mailbox mirrors the bitboards
+// so the board[8][8] helpers and printBoard can still be pointed at it.
+typedef struct {
+    Bitboard pieces[NUM_PIECE_TYPES];  // One set per piece type and color
+    Bitboard colors[2];                // Occupancy per color
+    Bitboard occupied;                 // Union of both colors
+    char board[8][8];                  // Mailbox, same layout as the UI board
+    unsigned char pieceList[NUM_PIECE_TYPES][MAX_PIECES_PER_TYPE];  // Squares of each piece
+    unsigned char pieceCount[NUM_PIECE_TYPES];
+    signed char listSlot[NUM_SQUARES];  // Index of a square's piece in its list, -1 if empty
+    int kingSquare[2];                 // Per color, NO_SQUARE if missing
+    int castling;                      // CASTLE_* bits still available
+    int epSquare;                      // En passant target square, NO_SQUARE if none
+    unsigned long long hash;           // Zobrist key of pieces, castling and en passant
+    unsigned long long pawnHash;       // Zobrist key of the pawns only
+    unsigned long long materialKey;    // Key of the piece counts alone (see putPiece)
+    int mgScore;                       // Sum of pieceSquareMg over the pieces (white positive)
+    int egScore;                       // Same for pieceSquareEg
+    int phase;                         // Sum of piecePhase, unclamped
+    UndoRecord undoStack[MAX_UNDO];    // Records of the moves made since positionFromBoard
+    int undoCount;
+} Position;
+
+// Zobrist keys, filled by initZobrist() from a fixed-seed 64-bit generator
+extern unsigned long long zobristPieces[NUM_PIECE_TYPES][NUM_SQUARES];
+extern unsigned long long zobristCastling[16];  // Indexed by castlingIndex()
+extern unsigned long long zobristEnPassant[8];  // By en passant file
+extern unsigned long long zobristSide;          // Black to move
+
+// Material plus piece-square scores per piece index and square, white positive.
+// Filled by the evaluator (initEvaluation) before any position is built, so the
+// primitives can keep mgScore/egScore/phase current.
+extern int pieceSquareMg[NUM_PIECE_TYPES][NUM_SQUARES];
+extern int pieceSquareEg[NUM_PIECE_TYPES][NUM_SQUARES];
+extern int piecePhase[NUM_PIECE_TYPES];
+
+// Build the Zobrist keys; safe to call more than once
+void initZobrist(void);
+
+// The UI's four castling flags packed as CASTLE_* bits
+int castlingIndex(GameState* state);
+
+// Material key of a set of piece counts, the same key putPiece() builds up
+unsigned long long materialKeyOf(const int counts[NUM_PIECE_TYPES]);
+
+// Full key for the TT: the incremental hash plus the side to move
+unsigned long long positionKey(Position* pos, int whiteToMove);
+
+// Map piece character to index (0-11), PIECE_NONE for empty squares
+int pieceIndex(char piece);
+char indexToPiece(int index);
+
+// Conversion to and from the char board used by main.c. The GameState is
+// copied into the compact castling mask and en passant square.
+void positionFromBoard(Position* pos, char board[8][8], GameState* state);
+void positionToBoard(Position* pos, char board[8][8]);
+
+// Primitive updates that keep bitboards and mailbox in sync
+void putPiece(Position* pos, int square, char piece);
+void removePiece(Position* pos, int square);
+void movePiece(Position* pos, int from, int to);
+
+// Attack queries on the bitboards (tables from initBitboards() must be built)
+int isAttacked(Position* pos, int square, int byWhite);
+int isInCheck(Position* pos, int whiteKing);
+
+// Pieces of both colors attacking a square, given an occupancy for the sliders
+Bitboard attackersTo(Position* pos, int square, Bitboard occupied);
+
+// Every piece's attacks on the current occupancy, built in one pass for the
+// evaluator and reusable by the move generator at the same node
+typedef struct {
+    Bitboard pieceAttacks[NUM_PIECE_TYPES][MAX_PIECES_PER_TYPE];  // Parallel to pieceList
+    Bitboard byPiece[NUM_PIECE_TYPES];  // Union over the pieces of one index
+    Bitboard bySide[2];                 // Squares attacked by a color
+    Bitboard twice[2];                  // Squares attacked by two or more of its pieces
+} AttackMaps;
+
+void computeAttackMaps(Position* pos, AttackMaps* maps);
+
+#endif
@@ -0,0 +1,559 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "bitboard.h"
+#include "position.h"
+#include "moves.h"
+#include "gameState.h"
+#include "bot/tablebase.h"
+
+// ============================================================================
+// TABLEBASE GENERATOR
+// ============================================================================
+//
+// Usage: tbgen [-o dir] [-j threads] [ENDING...]
+//
+// Solves each ending by retrograde analysis with the engine's own move
+// generator, generating the endings its captures and promotions lead to
+// first. Castling and en passant are not part of tablebase positions.
+
+#define MAX_LEVELS 255  // DTM is stored in a byte
+#define MAX_THREADS 64
+
+// Per-position state during generation
+#define ST_SKIP 0      // Not the canonical index of its position
+#define ST_ILLEGAL 1
+#define ST_UNKNOWN 2
+#define ST_WIN 3
+#define ST_LOSS 4
+#define ST_DRAW 5
+
+// Best result among the moves that leave the table (captures, promotions)
+#define OUT_NONE 0
+#define OUT_WIN 1
+#define OUT_DRAW 2
+#define OUT_LOSS 3
+
+static const char* defaultEndings[] = {
+    "KQK", "KRK", "KBK", "KNK", "KPK",
+    "KBNK", "KBBK", "KQKR", "KRKB", "KRKN", "KQKP", "KRKP", NULL
+};
+
+// Entries are numbered side to move * size + index
+typedef struct {
+    unsigned int* items;
+    size_t count;
+    size_t capacity;
+} EntryList;
+
+typedef struct {
+    Tablebase tb;
+    long entries;
+    unsigned char* state;
+    unsigned char* dist;
+    unsigned char* remaining;  // In-table successors not yet known to be lost for us
+    unsigned char* outState;
+    unsigned char* outDist;
+    EntryList levels[MAX_LEVELS + 1];
+} Generation;
+
+typedef struct {
+    Generation* gen;
+    long begin;
+    long end;
+    int level;
+    const unsigned int* work;
+    EntryList levels[MAX_LEVELS + 1];  // Entries this thread scheduled
+    int failed;
+} Worker;
+
+static const char* outputDir = TB_DEFAULT_PATH;
+static int numThreads = 1;
+
+static void pushEntry(EntryList* list, unsigned int entry) {
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 1024;
+        list->items = (unsigned int*)realloc(list->items, list->capacity * sizeof(unsigned int));
+        if (list->items == NULL) {
+            fprintf(stderr, "tbgen: out of memory\n");
+            exit(1);
+        }
+    }
+    list->items[list->count++] = entry;
+}
+
+// Move every thread's scheduled entries into the generation's level lists
+static void mergeLevels(Generation* gen, Worker* workers) {
+    for (int t = 0; t < numThreads; t++) {
+        for (int level = 0; level <= MAX_LEVELS; level++) {
+            EntryList* from = &workers[t].levels[level];
+            for (size_t i = 0; i < from->count; i++) pushEntry(&gen->levels[level], from->items[i]);
+            from->count = 0;
+        }
+    }
+}
+
+static void runWorkers(Worker* workers, void* (*job)(void*)) {
+    pthread_t threads[MAX_THREADS];
+    for (int t = 1; t < numThreads; t++) pthread_create(&threads[t], NULL, job, &workers[t]);
+    job(&workers[0]);
+    for (int t = 1; t < numThreads; t++) pthread_join(threads[t], NULL);
+}
+
+// ============================================================================
+// POSITIONS
+// ============================================================================
+
+// Set up a placement; 0 if men overlap or a pawn stands on a back rank
+static int setupPosition(Position* pos, const Tablebase* tb, const int squares[]) {
+    static GameState noRights = {0, 0, 0, 0, -1, -1, 0};
+    char board[8][8];
+    memset(board, '.', sizeof(board));
+
+    for (int i = 0; i < tb->numPieces; i++) {
+        int row = SQUARE_ROW(squares[i]);
+        int col = SQUARE_COL(squares[i]);
+        if (board[row][col] != '.') return 0;
+        if (tb->pieces[i] % 6 == PAWN && (row == 0 || row == 7)) return 0;
+        board[row][col] = indexToPiece(tb->pieces[i]);
+    }
+    positionFromBoard(pos, board, &noRights);
+    return 1;
+}
+
+static int slotAt(const Tablebase* tb, const int squares[], int square) {
+    for (int i = 0; i < tb->numPieces; i++) {
+        if (squares[i] == square) return i;
+    }
+    return -1;
+}
+
+// Result of a move that leaves the table, looked up in the smaller ending
+static int probeExit(Position* pos, Move move, int whiteToMove, int* result, int* plies) {
+    int from = MOVE_FROM(move);
+    int to = MOVE_TO(move);
+    char mover = pos->board[SQUARE_ROW(from)][SQUARE_COL(from)];
+    char captured = pos->board[SQUARE_ROW(to)][SQUARE_COL(to)];
+
+    if (captured != '.') removePiece(pos, to);
+    if (IS_PROMOTION(move)) {
+        removePiece(pos, from);
+        putPiece(pos, to, indexToPiece(PIECE_INDEX(whiteToMove ? COLOR_WHITE : COLOR_BLACK,
+                                                   PROMOTION_TYPE(move))));
+    } else {
+        movePiece(pos, from, to);
+    }
+
+    int wdl, childPlies;
+    int found = probeTablebaseDTM(pos, !whiteToMove, &wdl, &childPlies);
+
+    if (IS_PROMOTION(move)) {
+        removePiece(pos, to);
+        putPiece(pos, from, mover);
+    } else {
+        movePiece(pos, to, from);
+    }
+    if (captured != '.') putPiece(pos, to, captured);
+
+    // The child's result is for the opponent
+    *result = (wdl == TB_WIN) ? OUT_LOSS : (wdl == TB_LOSS) ? OUT_WIN : OUT_DRAW;
+    *plies = childPlies + 1;
+    return found;
+}
+
+// ============================================================================
+// INITIAL PASS
+// ============================================================================
+
+// Classify each position from its own moves: illegal, mate, stalemate, the
+// best result of leaving the table, and how many in-table successors it has
+static void* initialJob(void* arg) {
+    Worker* w = (Worker*)arg;
+    Generation* gen = w->gen;
+    const Tablebase* tb = &gen->tb;
+    Position* pos = (Position*)malloc(sizeof(Position));
+
+    for (long entry = w->begin; entry < w->end; entry++) {
+        int whiteToMove = entry < tb->size;
+        long index = entry % tb->size;
+        int squares[TB_MAX_PIECES];
+
+        if (!tablebaseSquares(tb, index, squares)) {
+            gen->state[entry] = ST_SKIP;
+            continue;
+        }
+        // The side that just moved cannot be in check
+        if (!setupPosition(pos, tb, squares) || isInCheck(pos, !whiteToMove)) {
+            gen->state[entry] = ST_ILLEGAL;
+            continue;
+        }
+
+        MoveList list;
+        generateLegalMoves(pos, whiteToMove, &list);
+        if (list.count == 0) {
+            if (isInCheck(pos, whiteToMove)) {
+                gen->state[entry] = ST_UNKNOWN;
+                pushEntry(&w->levels[0], (unsigned int)entry);
+            } else {
+                gen->state[entry] = ST_DRAW;
+            }
+            continue;
+        }
+
+        // Successors inside the table are counted once per distinct index
+        long children[MAX_MOVES];
+        int numChildren = 0;
+        int out = OUT_NONE, outPlies = 0;
+
+        for (int i = 0; i < list.count; i++) {
+            Move move = list.moves[i];
+            int from = MOVE_FROM(move);
+            int to = MOVE_TO(move);
+
+            if (IS_PROMOTION(move) || (pos->occupied & SQUARE_BB(to))) {
+                int result, plies;
+                if (!probeExit(pos, move, whiteToMove, &result, &plies)) {
+                    w->failed = 1;
+                    continue;
+                }
+                // Shortest win, else a draw, else the longest loss
+                if (result == OUT_WIN && (out != OUT_WIN || plies < outPlies)) {
+                    out = OUT_WIN;
+                    outPlies = plies;
+                } else if (result == OUT_DRAW && out != OUT_WIN) {
+                    out = OUT_DRAW;
+                } else if (result == OUT_LOSS && (out == OUT_NONE || (out == OUT_LOSS && plies > outPlies))) {
+                    out = OUT_LOSS;
+                    outPlies = plies;
+                }
+                continue;
+            }
+
+            int child[TB_MAX_PIECES];
+            memcpy(child, squares, sizeof(child));
+            child[slotAt(tb, squares, from)] = to;
+            long childIndex = tablebaseIndex(tb, child);
+            int seen = 0;
+            for (int j = 0; j < numChildren && !seen; j++) seen = (children[j] == childIndex);
+            if (!seen) children[numChildren++] = childIndex;
+        }
+
+        gen->state[entry] = ST_UNKNOWN;
+        gen->remaining[entry] = (unsigned char)numChildren;
+        gen->outState[entry] = (unsigned char)out;
+        gen->outDist[entry] = (unsigned char)outPlies;
+
+        if (out == OUT_WIN) {
+            pushEntry(&w->levels[outPlies], (unsigned int)entry);
+        } else if (numChildren == 0) {
+            if (out == OUT_LOSS) pushEntry(&w->levels[outPlies], (unsigned int)entry);
+            else gen->state[entry] = ST_DRAW;
+        }
+    }
+    free(pos);
+    return NULL;
+}
+
+// ============================================================================
+// RETROGRADE PASS
+// ============================================================================
+
+// Walk back from positions settled at this level: every predecessor of a
+// loss is a win one ply further, and a predecessor whose last successor
+// turned out won for us is a loss
+static void* retroJob(void* arg) {
+    Worker* w = (Worker*)arg;
+    Generation* gen = w->gen;
+    const Tablebase* tb = &gen->tb;
+    Position* pos = (Position*)malloc(sizeof(Position));
+
+    for (long n = w->begin; n < w->end; n++) {
+        long entry = w->work[n];
+        int whiteToMove = entry < tb->size;
+        int squares[TB_MAX_PIECES];
+        tablebaseSquares(tb, entry % tb->size, squares);
+        setupPosition(pos, tb, squares);
+
+        int lost = gen->state[entry] == ST_LOSS;
+        int moverColor = whiteToMove ? COLOR_BLACK : COLOR_WHITE;
+        long offset = whiteToMove ? tb->size : 0;  // Predecessors have the other side to move
+        long predecessors[MAX_MOVES];
+        int numPredecessors = 0;
+
+        for (int slot = 0; slot < tb->numPieces; slot++) {
+            int piece = tb->pieces[slot];
+            if (piece / 6 != moverColor) continue;
+
+            int to = squares[slot];
+            int type = piece % 6;
+            Bitboard empty = ~pos->occupied;
+            Bitboard origins;
+
+            if (type == PAWN) {
+                // Pawns step back toward their own side, never onto the back rank
+                int back = (moverColor == COLOR_WHITE) ? 8 : -8;
+                int startRow = (moverColor == COLOR_WHITE) ? 6 : 1;
+                origins = 0;
+                int one = to + back;
+                if (SQUARE_ROW(one) >= 1 && SQUARE_ROW(one) <= 6 && (empty & SQUARE_BB(one))) {
+                    origins |= SQUARE_BB(one);
+                    int two = one + back;
+                    if (SQUARE_ROW(two) == startRow && (empty & SQUARE_BB(two))) origins |= SQUARE_BB(two);
+                }
+            } else if (type == KNIGHT) {
+                origins = knightAttacks[to] & empty;
+            } else if (type == BISHOP) {
+                origins = bishopAttacks(to, pos->occupied) & empty;
+            } else if (type == ROOK) {
+                origins = rookAttacks(to, pos->occupied) & empty;
+            } else if (type == QUEEN) {
+                origins = queenAttacks(to, pos->occupied) & empty;
+            } else {
+                origins = kingAttacks[to] & empty;
+            }
+
+            while (origins) {
+                int from = popLsb(&origins);
+                // The side to move here must not have been in check before
+                movePiece(pos, to, from);
+                int illegal = isInCheck(pos, whiteToMove);
+                movePiece(pos, from, to);
+                if (illegal) continue;
+
+                int before[TB_MAX_PIECES];
+                memcpy(before, squares, sizeof(before));
+                before[slot] = from;
+                long predecessor = offset + tablebaseIndex(tb, before);
+                int seen = 0;
+                for (int j = 0; j < numPredecessors && !seen; j++) seen = (predecessors[j] == predecessor);
+                if (!seen) predecessors[numPredecessors++] = predecessor;
+            }
+        }
+
+        for (int i = 0; i < numPredecessors; i++) {
+            long p = predecessors[i];
+            if (gen->state[p] != ST_UNKNOWN) continue;
+            if (lost) {
+                pushEntry(&w->levels[w->level + 1], (unsigned int)p);
+            } else if (__atomic_sub_fetch(&gen->remaining[p], 1, __ATOMIC_RELAXED) == 0 &&
+                       (gen->outState[p] == OUT_NONE || gen->outState[p] == OUT_LOSS)) {
+                int level = w->level + 1;
+                if (gen->outState[p] == OUT_LOSS && gen->outDist[p] > level) level = gen->outDist[p];
+                pushEntry(&w->levels[level], (unsigned int)p);
+            }
+        }
+    }
+    free(pos);
+    return NULL;
+}
+
+// ============================================================================
+// DRIVER
+// ============================================================================
+
+static int writeTables(Generation* gen) {
+    char path[512];
+    long entries = gen->entries;
+    unsigned long long count = (unsigned long long)entries;
+    unsigned char header[TB_HEADER_SIZE];
+    unsigned char* wdl = (unsigned char*)calloc((entries + 3) / 4, 1);
+    unsigned char* dtm = (unsigned char*)calloc(entries, 1);
+    if (wdl == NULL || dtm == NULL) return 0;
+
+    for (long e = 0; e < entries; e++) {
+        int result = TB_ILLEGAL;
+        if (gen->state[e] == ST_WIN) result = TB_WIN;
+        else if (gen->state[e] == ST_LOSS) result = TB_LOSS;
+        else if (gen->state[e] == ST_DRAW || gen->state[e] == ST_UNKNOWN) result = TB_DRAW;
+        wdl[e / 4] |= result << ((e % 4) * 2);
+        if (result == TB_WIN || result == TB_LOSS) dtm[e] = gen->dist[e] + 1;
+    }
+
+    int ok = 1;
+    const char* extensions[2] = {"wdl", "dtm"};
+    const char* magics[2] = {TB_WDL_MAGIC, TB_DTM_MAGIC};
+    const unsigned char* data[2] = {wdl, dtm};
+    size_t sizes[2] = {(size_t)(entries + 3) / 4, (size_t)entries};
+    for (int f = 0; f < 2; f++) {
+        snprintf(path, sizeof(path), "%s/%s.%s", outputDir, gen->tb.name, extensions[f]);
+        FILE* file = fopen(path, "wb");
+        if (file == NULL) {
+            ok = 0;
+            break;
+        }
+        memcpy(header, magics[f], 8);
+        memcpy(header + 8, &count, 8);
+        ok = fwrite(header, 1, TB_HEADER_SIZE, file) == TB_HEADER_SIZE &&
+             fwrite(data[f], 1, sizes[f], file) == sizes[f];
+        ok = (fclose(file) == 0) && ok;
+        if (!ok) break;
+    }
+    free(wdl);
+    free(dtm);
+    return ok;
+}
+
+static void splitWork(Worker* workers, Generation* gen, long count, const unsigned int* work, int level) {
+    for (int t = 0; t < numThreads; t++) {
+        workers[t].gen = gen;
+        workers[t].begin = count * t / numThreads;
+        workers[t].end = count * (t + 1) / numThreads;
+        workers[t].work = work;
+        workers[t].level = level;
+    }
+}
+
+static int generate(const char* name);
+
+// Endings reached by a capture or a promotion come first
+static int generateDependencies(const Tablebase* tb) {
+    for (int i = 0; i < tb->numPieces; i++) {
+        int type = tb->pieces[i] % 6;
+        if (type == KING) continue;
+
+        char smaller[TB_MAX_PIECES + 1];
+        int length = 0;
+        for (int j = 0; j < tb->numPieces; j++) {
+            if (j != i) smaller[length++] = tb->name[j];
+        }
+        smaller[length] = '\0';
+        if (length > 2 && !generate(smaller)) return 0;
+
+        if (type == PAWN) {
+            const char* promotions = "QRBN";
+            for (int p = 0; promotions[p]; p++) {
+                char promoted[TB_MAX_PIECES + 1];
+                strcpy(promoted, tb->name);
+                promoted[i] = promotions[p];
+                if (!generate(promoted)) return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+static int generate(const char* name) {
+    Generation* gen = (Generation*)calloc(1, sizeof(Generation));
+    if (gen == NULL || !parseTablebaseName(name, &gen->tb)) {
+        fprintf(stderr, "tbgen: bad ending %s\n", name);
+        free(gen);
+        return 0;
+    }
+    if (loadTablebase(outputDir, gen->tb.name)) {
+        // Already on disk, but its own dependencies must still be loaded
+        int ok = generateDependencies(&gen->tb);
+        free(gen);
+        return ok;
+    }
+    if (!generateDependencies(&gen->tb)) {
+        free(gen);
+        return 0;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    long entries = gen->entries = 2 * gen->tb.size;
+    gen->state = (unsigned char*)calloc(entries, 1);
+    gen->dist = (unsigned char*)calloc(entries, 1);
+    gen->remaining = (unsigned char*)calloc(entries, 1);
+    gen->outState = (unsigned char*)calloc(entries, 1);
+    gen->outDist = (unsigned char*)calloc(entries, 1);
+    Worker* workers = (Worker*)calloc(numThreads, sizeof(Worker));
+    if (!gen->state || !gen->dist || !gen->remaining || !gen->outState || !gen->outDist || !workers) {
+        fprintf(stderr, "tbgen: out of memory for %s\n", gen->tb.name);
+        exit(1);
+    }
+
+    splitWork(workers, gen, entries, NULL, 0);
+    runWorkers(workers, initialJob);
+    int failed = 0;
+    for (int t = 0; t < numThreads; t++) failed |= workers[t].failed;
+    if (failed) {
+        fprintf(stderr, "tbgen: %s reached an ending that is not available\n", gen->tb.name);
+        exit(1);
+    }
+    mergeLevels(gen, workers);
+
+    // Settle positions level by level, so each gets its shortest distance
+    long wins = 0, losses = 0;
+    int maxLevel = 0;
+    EntryList settled = {NULL, 0, 0};
+    for (int level = 0; level < MAX_LEVELS; level++) {
+        EntryList* list = &gen->levels[level];
+        settled.count = 0;
+        for (size_t i = 0; i < list->count; i++) {
+            unsigned int e = list->items[i];
+            if (gen->state[e] != ST_UNKNOWN) continue;
+            // Odd plies from mate are wins for the side to move, even ones losses
+            gen->state[e] = (level % 2) ? ST_WIN : ST_LOSS;
+            gen->dist[e] = (unsigned char)level;
+            if (level % 2) wins++;
+            else losses++;
+            maxLevel = level;
+            pushEntry(&settled, e);
+        }
+        free(list->items);
+        list->items = NULL;
+
+        splitWork(workers, gen, (long)settled.count, settled.items, level);
+        runWorkers(workers, retroJob);
+        mergeLevels(gen, workers);
+    }
+
+    int ok = writeTables(gen) && loadTablebase(outputDir, gen->tb.name);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("%-6s %9ld positions, %9ld wins, %9ld losses, longest mate %3d plies, %.1fs\n",
+           gen->tb.name, entries, wins, losses, maxLevel, seconds);
+
+    free(settled.items);
+    for (int t = 0; t < numThreads; t++) {
+        for (int level = 0; level <= MAX_LEVELS; level++) free(workers[t].levels[level].items);
+    }
+    for (int level = 0; level <= MAX_LEVELS; level++) free(gen->levels[level].items);
+    free(workers);
+    free(gen->state);
+    free(gen->dist);
+    free(gen->remaining);
+    free(gen->outState);
+    free(gen->outDist);
+    free(gen);
+    if (!ok) fprintf(stderr, "tbgen: could not write %s to %s\n", name, outputDir);
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    numThreads = cores > 0 ? (int)cores : 1;
+
+    int first = 1;
+    while (first < argc && argv[first][0] == '-') {
+        if (strcmp(argv[first], "-o") == 0 && first + 1 < argc) {
+            outputDir = argv[first + 1];
+        } else if (strcmp(argv[first], "-j") == 0 && first + 1 < argc) {
+            numThreads = atoi(argv[first + 1]);
+        } else {
+            fprintf(stderr, "Usage: %s [-o dir] [-j threads] [ENDING...]\n", argv[0]);
+            return 1;
+        }
+        first += 2;
+    }
+    if (numThreads < 1) numThreads = 1;
+    if (numThreads > MAX_THREADS) numThreads = MAX_THREADS;
+
+    initBitboards();
+    mkdir(outputDir, 0755);
+    printf("Generating into %s/ with %d thread%s\n", outputDir, numThreads, numThreads > 1 ? "s" : "");
+
+    int ok = 1;
+    if (first < argc) {
+        for (int i = first; i < argc && ok; i++) ok = generate(argv[i]);
+    } else {
+        for (int i = 0; defaultEndings[i] && ok; i++) ok = generate(defaultEndings[i]);
+    }
+    return ok ? 0 : 1;
+}